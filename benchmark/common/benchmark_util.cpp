@@ -0,0 +1,142 @@
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "bsgs.hpp"
+#include "orbit.hpp"
+#include "perm.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+#include "task_mapping.hpp"
+
+#include "benchmark_util.hpp"
+
+using namespace mpsym;
+using namespace mpsym::internal;
+
+namespace benchmark_util
+{
+
+char const *family_name(Family family)
+{
+  switch (family) {
+    case SYMMETRIC:
+      return "symmetric";
+    case CYCLIC:
+      return "cyclic";
+    case DIHEDRAL:
+      return "dihedral";
+    case WREATH:
+      return "wreath";
+    case NUM_FAMILIES:
+      break;
+  }
+
+  throw std::logic_error("unreachable");
+}
+
+PermGroup make_group(Family family,
+                     unsigned degree,
+                     BSGSOptions const *bsgs_options)
+{
+  PermSet generators;
+
+  switch (family) {
+    case SYMMETRIC:
+      generators = PermGroup::symmetric(degree).generators();
+      break;
+    case CYCLIC:
+      generators = PermGroup::cyclic(degree).generators();
+      break;
+    case DIHEDRAL:
+      // PermGroup::dihedral expects the group order
+      generators = PermGroup::dihedral(2u * degree).generators();
+      break;
+    case WREATH:
+      assert(degree % 2u == 0u);
+      generators = PermGroup::wreath_product_generators(
+        PermGroup::symmetric(2u), PermGroup::symmetric(degree / 2u));
+      break;
+    case NUM_FAMILIES:
+      throw std::logic_error("unreachable");
+  }
+
+  // rebuild the BSGS so that 'bsgs_options' always applies
+  return PermGroup(BSGS(degree, generators, bsgs_options));
+}
+
+PermSet random_perms(PermGroup const &group, unsigned num_perms)
+{
+  // like PermGroup::random_element but with a fixed seed
+  std::mt19937 re(SEED);
+
+  auto const &bsgs(group.bsgs());
+
+  PermSet perms;
+
+  for (unsigned i = 0u; i < num_perms; ++i) {
+    Perm perm(group.degree());
+
+    for (unsigned j = 0u; j < bsgs.base_size(); ++j) {
+      auto orbit(bsgs.orbit(j));
+
+      std::uniform_int_distribution<unsigned> d(0u, orbit.size() - 1u);
+
+      perm *= bsgs.transversal(j, *(orbit.begin() + d(re)));
+    }
+
+    perms.insert(perm);
+  }
+
+  return perms;
+}
+
+std::vector<TaskMapping> random_task_mappings(unsigned degree,
+                                              unsigned num_tasks,
+                                              unsigned num_mappings)
+{
+  std::mt19937 re(SEED);
+  std::uniform_int_distribution<unsigned> d(0u, degree - 1u);
+
+  std::vector<TaskMapping> mappings;
+  mappings.reserve(num_mappings);
+
+  for (unsigned i = 0u; i < num_mappings; ++i) {
+    std::vector<unsigned> tasks(num_tasks);
+    for (auto &task : tasks)
+      task = d(re);
+
+    mappings.emplace_back(tasks);
+  }
+
+  return mappings;
+}
+
+void family_degree_args(benchmark::internal::Benchmark *b)
+{
+  b->ArgNames({"family", "degree"});
+
+  for (int64_t family = 0; family < NUM_FAMILIES; ++family) {
+    for (int64_t degree : {8, 16, 32})
+      b->Args({family, degree});
+  }
+}
+
+void family_degree_tasks_args(benchmark::internal::Benchmark *b)
+{
+  b->ArgNames({"family", "degree", "tasks"});
+
+  for (int64_t family = 0; family < NUM_FAMILIES; ++family) {
+    for (int64_t degree : {8, 16, 32}) {
+      for (int64_t num_tasks : {4, 8, 16}) {
+        if (num_tasks <= degree)
+          b->Args({family, degree, num_tasks});
+      }
+    }
+  }
+}
+
+} // namespace benchmark_util
@@ -0,0 +1,54 @@
+#ifndef _GUARD_BENCHMARK_UTIL_H
+#define _GUARD_BENCHMARK_UTIL_H
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "bsgs.hpp"
+#include "perm.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+#include "task_mapping.hpp"
+
+namespace benchmark_util
+{
+
+// group families fixtures can be parameterized over, all of them are
+// constructed on exactly 'degree' points
+enum Family : int64_t
+{
+  SYMMETRIC,
+  CYCLIC,
+  DIHEDRAL,
+  WREATH, // S_2 wr S_(degree / 2), degree must be even
+  NUM_FAMILIES
+};
+
+char const *family_name(Family family);
+
+// all benchmark inputs are pseudo-random but seeded deterministically so that
+// runs of the same binary are comparable
+enum : unsigned { SEED = 42u };
+
+mpsym::internal::PermGroup make_group(
+  Family family,
+  unsigned degree,
+  mpsym::internal::BSGSOptions const *bsgs_options = nullptr);
+
+mpsym::internal::PermSet random_perms(mpsym::internal::PermGroup const &group,
+                                      unsigned num_perms);
+
+std::vector<mpsym::TaskMapping> random_task_mappings(unsigned degree,
+                                                     unsigned num_tasks,
+                                                     unsigned num_mappings);
+
+// argument ranges shared by all fixtures, 'Apply'-ed to a benchmark with
+// arguments (family, degree) or (family, degree, num_tasks)
+void family_degree_args(benchmark::internal::Benchmark *b);
+void family_degree_tasks_args(benchmark::internal::Benchmark *b);
+
+} // namespace benchmark_util
+
+#endif // _GUARD_BENCHMARK_UTIL_H
@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "arch_graph.hpp"
+
+using namespace mpsym;
+
+namespace
+{
+
+// arguments: (side, channel types, encoding), every channel type beyond the
+// first three adds another class of express channels so the graphs also grow
+// with the number of channel types
+void arch_graph_args(benchmark::internal::Benchmark *b)
+{
+  b->ArgNames({"side", "channel_types", "encoding"});
+
+  for (int64_t side : {8, 16, 32}) {
+    for (int64_t channel_types : {3, 4, 8}) {
+      for (auto encoding : {ArchGraph::NautyEncoding::AUTO,
+                            ArchGraph::NautyEncoding::LAYERED,
+                            ArchGraph::NautyEncoding::SUBDIVIDED}) {
+        b->Args({side, channel_types, static_cast<int64_t>(encoding)});
+      }
+    }
+  }
+}
+
+char const *encoding_name(ArchGraph::NautyEncoding encoding)
+{
+  switch (encoding) {
+    case ArchGraph::NautyEncoding::AUTO:
+      return "auto";
+    case ArchGraph::NautyEncoding::LAYERED:
+      return "layered";
+    case ArchGraph::NautyEncoding::SUBDIVIDED:
+      return "subdivided";
+  }
+
+  return "";
+}
+
+// heterogeneous interconnect: side x side mesh with distinct horizontal and
+// vertical channels, local memory channels on every processor and row express
+// channels spanning 2, 3, ... processors for every further channel type
+std::shared_ptr<ArchGraph> make_interconnect(unsigned side,
+                                             unsigned channel_types)
+{
+  auto ag(std::make_shared<ArchGraph>(false));
+
+  ag->add_processors(side * side, "P");
+
+  for (unsigned y = 0u; y < side; ++y) {
+    for (unsigned x = 0u; x < side; ++x) {
+      unsigned pe = y * side + x;
+
+      ag->add_channel(pe, pe, "M");
+
+      if (x + 1u < side)
+        ag->add_channel(pe, pe + 1u, "H");
+
+      if (y + 1u < side)
+        ag->add_channel(pe, pe + side, "V");
+
+      for (unsigned t = 3u; t < channel_types; ++t) {
+        unsigned span = t - 1u;
+
+        if (x + span < side)
+          ag->add_channel(pe, pe + span, "E" + std::to_string(span));
+      }
+    }
+  }
+
+  return ag;
+}
+
+class ArchGraphFixture : public benchmark::Fixture
+{
+public:
+  void SetUp(benchmark::State const &state) override
+  {
+    auto side(static_cast<unsigned>(state.range(0)));
+    auto channel_types(static_cast<unsigned>(state.range(1)));
+
+    ag = make_interconnect(side, channel_types);
+
+    ag->set_nauty_encoding(
+      static_cast<ArchGraph::NautyEncoding>(state.range(2)));
+  }
+
+  void TearDown(benchmark::State const &) override
+  { ag.reset(); }
+
+  std::shared_ptr<ArchGraph> ag;
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(ArchGraphFixture, Automorphisms)(benchmark::State &state)
+{
+  state.SetLabel(
+    encoding_name(static_cast<ArchGraph::NautyEncoding>(state.range(2))));
+
+  for (auto _ : state) {
+    ag->reset_automorphisms();
+
+    auto automorphisms(ag->automorphisms());
+    benchmark::DoNotOptimize(automorphisms);
+  }
+
+  state.counters["channels"] = ag->num_channels();
+}
+
+BENCHMARK_REGISTER_F(ArchGraphFixture, Automorphisms)
+  ->Apply(arch_graph_args)
+  ->Unit(benchmark::kMillisecond);
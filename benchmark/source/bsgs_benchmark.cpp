@@ -0,0 +1,208 @@
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "bsgs.hpp"
+#include "orbit.hpp"
+#include "perm.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+
+#include "benchmark_util.hpp"
+
+using namespace mpsym::internal;
+
+using namespace benchmark_util;
+
+namespace
+{
+
+enum : unsigned { NUM_PERMS = 64u };
+
+// arguments: (family, degree, transversals)
+void bsgs_args(benchmark::internal::Benchmark *b)
+{
+  b->ArgNames({"family", "degree", "transversals"});
+
+  for (int64_t family = 0; family < NUM_FAMILIES; ++family) {
+    for (int64_t degree : {8, 16, 32}) {
+      for (auto transversals : {BSGSOptions::Transversals::EXPLICIT,
+                                BSGSOptions::Transversals::SCHREIER_TREES}) {
+        b->Args({family, degree, static_cast<int64_t>(transversals)});
+      }
+    }
+  }
+}
+
+// arguments: (family, degree, batch size)
+void strip_batch_args(benchmark::internal::Benchmark *b)
+{
+  b->ArgNames({"family", "degree", "batch"});
+
+  for (int64_t family = 0; family < NUM_FAMILIES; ++family) {
+    for (int64_t degree : {16, 32}) {
+      for (int64_t batch : {1, 4, 16, 64})
+        b->Args({family, degree, batch});
+    }
+  }
+}
+
+// small batches of candidates stripped repeatedly against the same group, as
+// e.g. done by the disjoint decomposition for every orbit split
+struct StripBatchInput
+{
+  StripBatchInput(benchmark::State const &state)
+  {
+    auto family(static_cast<Family>(state.range(0)));
+    auto degree(static_cast<unsigned>(state.range(1)));
+    auto batch(static_cast<unsigned>(state.range(2)));
+
+    group = make_group(family, degree);
+
+    auto candidates(random_perms(make_group(SYMMETRIC, degree), batch));
+    perms = candidates;
+  }
+
+  PermGroup group;
+  PermSet perms;
+};
+
+class BSGSFixture : public benchmark::Fixture
+{
+public:
+  void SetUp(benchmark::State const &state) override
+  {
+    auto family(static_cast<Family>(state.range(0)));
+    auto degree(static_cast<unsigned>(state.range(1)));
+
+    BSGSOptions bsgs_options;
+    bsgs_options.transversals =
+      static_cast<BSGSOptions::Transversals>(state.range(2));
+
+    // the symmetry test is randomized and would change the BSGS between runs
+    bsgs_options.check_sym = false;
+
+    group = make_group(family, degree, &bsgs_options);
+
+    auto candidates(random_perms(make_group(SYMMETRIC, degree), NUM_PERMS / 2u));
+    auto members(random_perms(group, NUM_PERMS / 2u));
+
+    // mix of perms that strip completely and perms that (most likely) don't
+    perms = candidates;
+    perms.insert(members.begin(), members.end());
+
+    orbit_points.clear();
+    for (unsigned i = 0u; i < group.bsgs().base_size(); ++i) {
+      for (unsigned o : group.bsgs().orbit(i))
+        orbit_points.emplace_back(i, o);
+    }
+  }
+
+  void TearDown(benchmark::State const &) override
+  {
+    perms.clear();
+    orbit_points.clear();
+  }
+
+  PermGroup group;
+  PermSet perms;
+  std::vector<std::pair<unsigned, unsigned>> orbit_points;
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(BSGSFixture, Strip)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  auto const &bsgs(group.bsgs());
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    auto res(bsgs.strip(perms[i % NUM_PERMS]));
+    benchmark::DoNotOptimize(res);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(BSGSFixture, Transversal)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  auto const &bsgs(group.bsgs());
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    auto const &orbit_point(orbit_points[i % orbit_points.size()]);
+
+    Perm res(bsgs.transversal(orbit_point.first, orbit_point.second));
+    benchmark::DoNotOptimize(res);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(BSGSFixture, SchreierSims)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  BSGSOptions bsgs_options;
+  bsgs_options.construction = BSGSOptions::Construction::SCHREIER_SIMS;
+  bsgs_options.transversals =
+    static_cast<BSGSOptions::Transversals>(state.range(2));
+  bsgs_options.check_sym = false;
+
+  auto generators(group.generators());
+
+  for (auto _ : state) {
+    BSGS bsgs(generators.degree(), generators, &bsgs_options);
+    benchmark::DoNotOptimize(bsgs);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void StripsCompletelyEach(benchmark::State &state)
+{
+  StripBatchInput input(state);
+
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  auto const &bsgs(input.group.bsgs());
+
+  for (auto _ : state) {
+    for (Perm const &perm : input.perms) {
+      bool res = bsgs.strips_completely(perm);
+      benchmark::DoNotOptimize(res);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * input.perms.size());
+}
+
+void StripsCompletelyBatch(benchmark::State &state)
+{
+  StripBatchInput input(state);
+
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  auto const &bsgs(input.group.bsgs());
+
+  for (auto _ : state) {
+    auto res(bsgs.strips_completely(input.perms, 1u));
+    benchmark::DoNotOptimize(res);
+  }
+
+  state.SetItemsProcessed(state.iterations() * input.perms.size());
+}
+
+BENCHMARK(StripsCompletelyEach)->Apply(strip_batch_args);
+BENCHMARK(StripsCompletelyBatch)->Apply(strip_batch_args);
+
+BENCHMARK_REGISTER_F(BSGSFixture, Strip)->Apply(bsgs_args);
+BENCHMARK_REGISTER_F(BSGSFixture, Transversal)->Apply(bsgs_args);
+BENCHMARK_REGISTER_F(BSGSFixture, SchreierSims)->Apply(bsgs_args);
@@ -0,0 +1,115 @@
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+
+#include "orbit.hpp"
+#include "perm.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+
+#include "benchmark_util.hpp"
+
+using namespace mpsym::internal;
+
+using namespace benchmark_util;
+
+namespace
+{
+
+class OrbitFixture : public benchmark::Fixture
+{
+public:
+  void SetUp(benchmark::State const &state) override
+  {
+    auto family(static_cast<Family>(state.range(0)));
+    auto degree(static_cast<unsigned>(state.range(1)));
+
+    generators = make_group(family, degree).generators().with_inverses();
+  }
+
+  void TearDown(benchmark::State const &) override
+  { generators.clear(); }
+
+  PermSet generators;
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(OrbitFixture, Generate)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  unsigned x = 0u;
+  for (auto _ : state) {
+    auto orbit(Orbit::generate(x, generators));
+    benchmark::DoNotOptimize(orbit);
+    x = (x + 1u) % generators.degree();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(OrbitFixture, Generate)->Apply(family_degree_args);
+
+BENCHMARK_DEFINE_F(OrbitFixture, Partition)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  for (auto _ : state) {
+    OrbitPartition orbits(generators.degree(), generators);
+    benchmark::DoNotOptimize(orbits);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(OrbitFixture, Partition)->Apply(family_degree_args);
+
+// input of OrbitPartitionTest.CanConstructLargeOrbitPartition: mostly fixed
+// points, the memory counter covers all orbits of the partition
+namespace
+{
+
+void OrbitPartitionMostlyFixed(benchmark::State &state)
+{
+  auto degree(static_cast<unsigned>(state.range(0)));
+
+  PermSet generators;
+  for (unsigned i = 0u; i < degree / 16u; ++i)
+    generators.insert(Perm(degree, {{2u * i, 2u * i + 1u}}));
+
+  std::size_t memory = 0u;
+
+  for (auto _ : state) {
+    OrbitPartition orbits(degree, generators);
+    benchmark::DoNotOptimize(orbits);
+
+    memory = 0u;
+    for (auto const &orbit : orbits)
+      memory += orbit.memory_usage();
+  }
+
+  state.counters["memory"] = static_cast<double>(memory);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// input of OrbitTest.CanGenerateOrbit, membership of all points
+void OrbitContains(benchmark::State &state)
+{
+  PermSet generators({Perm(10, {{0, 2, 4}}), Perm(10, {{4, 6}, {8, 9}})});
+
+  auto orbit(Orbit::generate(2, generators.with_inverses()));
+
+  for (auto _ : state) {
+    for (unsigned x = 0u; x < 10u; ++x)
+      benchmark::DoNotOptimize(orbit.contains(x));
+  }
+
+  state.SetItemsProcessed(state.iterations() * 10);
+}
+
+} // anonymous namespace
+
+BENCHMARK(OrbitPartitionMostlyFixed)->RangeMultiplier(4)->Range(1 << 12, 1 << 16);
+
+BENCHMARK(OrbitContains);
@@ -0,0 +1,83 @@
+#include "benchmark/benchmark.h"
+
+#include "perm.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+
+#include "benchmark_util.hpp"
+
+using namespace mpsym::internal;
+
+using namespace benchmark_util;
+
+namespace
+{
+
+enum : unsigned { NUM_PERMS = 64u };
+
+class PermFixture : public benchmark::Fixture
+{
+public:
+  void SetUp(benchmark::State const &state) override
+  {
+    auto family(static_cast<Family>(state.range(0)));
+    auto degree(static_cast<unsigned>(state.range(1)));
+
+    perms = random_perms(make_group(family, degree), NUM_PERMS);
+  }
+
+  void TearDown(benchmark::State const &) override
+  { perms.clear(); }
+
+  PermSet perms;
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(PermFixture, Compose)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    Perm res(perms[i % NUM_PERMS] * perms[(i + 1u) % NUM_PERMS]);
+    benchmark::DoNotOptimize(res);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(PermFixture, ComposeInPlace)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  Perm res(perms[0]);
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    res *= perms[i % NUM_PERMS];
+    benchmark::ClobberMemory();
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(PermFixture, Invert)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    Perm res(~perms[i % NUM_PERMS]);
+    benchmark::DoNotOptimize(res);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(PermFixture, Compose)->Apply(family_degree_args);
+BENCHMARK_REGISTER_F(PermFixture, ComposeInPlace)->Apply(family_degree_args);
+BENCHMARK_REGISTER_F(PermFixture, Invert)->Apply(family_degree_args);
@@ -0,0 +1,105 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "arch_graph_automorphisms.hpp"
+#include "arch_graph_system.hpp"
+#include "perm_group.hpp"
+#include "task_mapping.hpp"
+
+#include "benchmark_util.hpp"
+
+using namespace mpsym;
+using namespace mpsym::internal;
+
+using namespace benchmark_util;
+
+namespace
+{
+
+enum : unsigned { NUM_MAPPINGS = 64u };
+
+// arguments: (family, degree, tasks, method), degrees are kept small since the
+// iterate and orbits methods enumerate entire groups or orbits
+void repr_args(benchmark::internal::Benchmark *b)
+{
+  b->ArgNames({"family", "degree", "tasks", "method"});
+
+  for (int64_t family = 0; family < NUM_FAMILIES; ++family) {
+    for (int64_t degree : {8, 12}) {
+      for (int64_t num_tasks : {4, 8}) {
+        for (auto method : {ReprOptions::Method::ITERATE,
+                            ReprOptions::Method::ORBITS,
+                            ReprOptions::Method::LOCAL_SEARCH}) {
+          b->Args({family, degree, num_tasks, static_cast<int64_t>(method)});
+        }
+      }
+    }
+  }
+}
+
+char const *method_name(ReprOptions::Method method)
+{
+  switch (method) {
+    case ReprOptions::Method::ITERATE:
+      return "iterate";
+    case ReprOptions::Method::ORBITS:
+      return "orbits";
+    case ReprOptions::Method::LOCAL_SEARCH:
+      return "local_search";
+  }
+
+  return "";
+}
+
+class ReprFixture : public benchmark::Fixture
+{
+public:
+  void SetUp(benchmark::State const &state) override
+  {
+    auto family(static_cast<Family>(state.range(0)));
+    auto degree(static_cast<unsigned>(state.range(1)));
+    auto num_tasks(static_cast<unsigned>(state.range(2)));
+
+    options.method = static_cast<ReprOptions::Method>(state.range(3));
+
+    automorphisms = std::make_shared<ArchGraphAutomorphisms>(
+      make_group(family, degree));
+
+    automorphisms->init_repr();
+
+    mappings = random_task_mappings(degree, num_tasks, NUM_MAPPINGS);
+  }
+
+  void TearDown(benchmark::State const &) override
+  {
+    automorphisms.reset();
+    mappings.clear();
+  }
+
+  ReprOptions options;
+  std::shared_ptr<ArchGraphSystem> automorphisms;
+  std::vector<TaskMapping> mappings;
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(ReprFixture, Repr)(benchmark::State &state)
+{
+  state.SetLabel(std::string(family_name(static_cast<Family>(state.range(0))))
+                 + "/" + method_name(options.method));
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    auto res(automorphisms->repr(mappings[i % NUM_MAPPINGS], &options));
+    benchmark::DoNotOptimize(res);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(ReprFixture, Repr)->Apply(repr_args);
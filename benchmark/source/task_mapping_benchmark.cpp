@@ -0,0 +1,117 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+#include "task_mapping.hpp"
+#include "task_mapping_orbit.hpp"
+
+#include "benchmark_util.hpp"
+
+using namespace mpsym;
+using namespace mpsym::internal;
+
+using namespace benchmark_util;
+
+namespace
+{
+
+enum : unsigned { NUM_PERMS = 64u, NUM_MAPPINGS = 1024u };
+
+class TaskMappingFixture : public benchmark::Fixture
+{
+public:
+  void SetUp(benchmark::State const &state) override
+  {
+    auto family(static_cast<Family>(state.range(0)));
+    auto degree(static_cast<unsigned>(state.range(1)));
+    auto num_tasks(static_cast<unsigned>(state.range(2)));
+
+    perms = random_perms(make_group(family, degree), NUM_PERMS);
+    mappings = random_task_mappings(degree, num_tasks, NUM_MAPPINGS);
+  }
+
+  void TearDown(benchmark::State const &) override
+  {
+    perms.clear();
+    mappings.clear();
+  }
+
+  PermSet perms;
+  std::vector<TaskMapping> mappings;
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(TaskMappingFixture, Permuted)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    auto res(mappings[i % NUM_MAPPINGS].permuted(perms[i % NUM_PERMS]));
+    benchmark::DoNotOptimize(res);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(TaskMappingFixture, LessThan)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    bool res = mappings[i % NUM_MAPPINGS].less_than(
+      mappings[(i + 1u) % NUM_MAPPINGS]);
+
+    benchmark::DoNotOptimize(res);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(TaskMappingFixture, LessThanPermuted)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  unsigned i = 0u;
+  for (auto _ : state) {
+    bool res = mappings[i % NUM_MAPPINGS].less_than(
+      mappings[(i + 1u) % NUM_MAPPINGS], perms[i % NUM_PERMS]);
+
+    benchmark::DoNotOptimize(res);
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(TaskMappingFixture, TMORsInsert)(benchmark::State &state)
+{
+  state.SetLabel(family_name(static_cast<Family>(state.range(0))));
+
+  for (auto _ : state) {
+    TMORs orbits;
+
+    for (auto const &mapping : mappings)
+      benchmark::DoNotOptimize(orbits.insert(mapping));
+  }
+
+  state.SetItemsProcessed(state.iterations() * NUM_MAPPINGS);
+}
+
+BENCHMARK_REGISTER_F(TaskMappingFixture, Permuted)
+  ->Apply(family_degree_tasks_args);
+
+BENCHMARK_REGISTER_F(TaskMappingFixture, LessThan)
+  ->Apply(family_degree_tasks_args);
+
+BENCHMARK_REGISTER_F(TaskMappingFixture, LessThanPermuted)
+  ->Apply(family_degree_tasks_args);
+
+BENCHMARK_REGISTER_F(TaskMappingFixture, TMORsInsert)
+  ->Apply(family_degree_tasks_args);
@@ -0,0 +1,16 @@
+cmake_minimum_required(VERSION 3.6)
+
+project(googlebenchmark-download NONE)
+
+include(ExternalProject)
+
+ExternalProject_Add(googlebenchmark
+  GIT_REPOSITORY    "https://github.com/google/benchmark.git"
+  GIT_TAG           "v1.7.1"
+  SOURCE_DIR        "${GBENCH_SRC_DIR}"
+  BINARY_DIR        "${GBENCH_BIN_DIR}"
+  CONFIGURE_COMMAND ""
+  BUILD_COMMAND     ""
+  INSTALL_COMMAND   ""
+  TEST_COMMAND      ""
+)
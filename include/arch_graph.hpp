@@ -2,6 +2,7 @@
 #define GUARD_ARCH_GRAPH_H
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -67,6 +68,37 @@ public:
 
   virtual ~ArchGraph() = default;
 
+  // Common (undirected) topologies, these are constructed in bulk and their
+  // automorphism groups are known in advance so nauty is not needed to
+  // determine them (unless the graph is modified afterwards).
+
+  // dims[0] x dims[1] x ... grid, processors are numbered in row major order
+  static std::shared_ptr<ArchGraph> mesh(std::vector<unsigned> const &dims,
+                                         std::string const &pl = "P",
+                                         std::string const &cl = "C");
+
+  // mesh with wrap-around channels along every dimension
+  static std::shared_ptr<ArchGraph> torus(std::vector<unsigned> const &dims,
+                                          std::string const &pl = "P",
+                                          std::string const &cl = "C");
+
+  // 2^dim processors, connected iff their indices differ in exactly one bit
+  static std::shared_ptr<ArchGraph> hypercube(unsigned dim,
+                                              std::string const &pl = "P",
+                                              std::string const &cl = "C");
+
+  // fat tree, i.e. a complete arity-ary tree of switches with arity^levels
+  // processors as leaves whose channels widen towards the root: a channel above
+  // a subtree with w leaves has type cl + std::to_string(w), e.g. "C1" for the
+  // processor channels and "C4" one level further up in a 4-ary tree,
+  // processors come first, followed by the switches level by level from the
+  // bottom up
+  static std::shared_ptr<ArchGraph> fat_tree(unsigned arity,
+                                             unsigned levels,
+                                             std::string const &pl = "P",
+                                             std::string const &sl = "S",
+                                             std::string const &cl = "C");
+
   std::string to_gap() const override;
   std::string to_json() const override;
 
@@ -145,6 +177,16 @@ public:
   bool directed() const;
   bool effectively_directed() const;
 
+  // Channel types are encoded into the graph passed to nauty either by
+  // stacking log2(#channel types) + 1 copies of all processors in layers
+  // (channels appear in the layers corresponding to the set bits of their
+  // type) or by subdividing every channel with a vertex colored by its type.
+  // By default, whichever encoding results in the smaller graph is used.
+  enum class NautyEncoding { AUTO, LAYERED, SUBDIVIDED };
+
+  void set_nauty_encoding(NautyEncoding encoding)
+  { _nauty_encoding = encoding; }
+
   unsigned num_processors() const override;
   unsigned num_channels() const override;
 
@@ -156,18 +198,43 @@ private:
     if (num_processors() == 0u)
       return internal::PermGroup();
 
+    if (_automorphisms_preset)
+      return automorphisms_preset(options);
+
     return automorphisms_nauty(options, aborted);
   }
 
   void init_repr_(AutomorphismOptions const *options,
                   internal::timeout::flag aborted) override
-  { automorphisms(options, aborted); }
+  {
+    automorphisms(options, aborted);
+    init_repr_decomposition(options, aborted);
+  }
+
+  std::size_t memory_usage_() const override;
+
+  void snapshot_structure_(internal::BinaryWriter &writer) const override;
+  void snapshot_state_(internal::BinaryWriter &writer) const override;
+  void restore_state_(internal::BinaryReader &reader,
+                      AutomorphismOptions const *options) override;
 
   // Convenience functions
 
   ChannelType assert_channel_type(std::string const &cl);
   ProcessorType assert_processor_type(std::string const &cl);
 
+  // bulk construction, channels are not checked for duplicates
+  void add_processors_unchecked(unsigned n, ProcessorType pt);
+  void add_channels_unchecked(
+    std::vector<std::pair<unsigned, unsigned>> const &channels,
+    ChannelType ct);
+
+  // automorphisms known in advance, discarded as soon as the graph is modified
+  void set_automorphisms_preset(internal::BSGS::Base const &base,
+                                internal::PermSet const &strong_generators);
+
+  internal::PermGroup automorphisms_preset(AutomorphismOptions const *options);
+
   bool channel_exists(unsigned from, unsigned to, ChannelType ct) const;
   bool channel_exists_directed(unsigned from, unsigned to, ChannelType ct) const;
   bool channel_exists_undirected(unsigned from, unsigned to, ChannelType ct) const;
@@ -214,7 +281,11 @@ private:
 
   // Nauty
 
+  NautyEncoding nauty_encoding() const;
+
   internal::NautyGraph graph_nauty() const;
+  internal::NautyGraph graph_nauty_layered() const;
+  internal::NautyGraph graph_nauty_subdivided() const;
 
   std::string to_gap_nauty() const;
 
@@ -232,6 +303,18 @@ private:
 
   std::vector<vertices_size_type> _processor_type_instances;
   std::vector<edges_size_type> _channel_type_instances;
+
+  NautyEncoding _nauty_encoding = NautyEncoding::AUTO;
+
+  // base and strong generating set of the automorphism group, the BSGS itself
+  // is only constructed once requested so that the caller's options apply
+  struct AutomorphismsPreset
+  {
+    internal::BSGS::Base base;
+    internal::PermSet strong_generators;
+  };
+
+  std::shared_ptr<AutomorphismsPreset const> _automorphisms_preset;
 };
 
 }
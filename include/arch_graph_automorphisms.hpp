@@ -1,6 +1,7 @@
 #ifndef GUARD_ARCH_GRAPH_AUTOMORPHISMS_H
 #define GUARD_ARCH_GRAPH_AUTOMORPHISMS_H
 
+#include <cstddef>
 #include <sstream>
 #include <sstream>
 #include <string>
@@ -67,6 +68,23 @@ private:
                            internal::timeout::flag) override
   { return _automorphisms; }
 
+  // once determined, the inherited automorphisms are a copy of _automorphisms
+  std::size_t memory_usage_() const override
+  {
+    return memory_usage_automorphisms(&_automorphisms) +
+           _automorphisms.memory_usage();
+  }
+
+  void snapshot_structure_(BinaryWriter &writer) const override;
+
+  // the automorphisms are already part of the structure
+  void snapshot_automorphisms_(BinaryWriter &) const override
+  {}
+
+  PermGroup restore_automorphisms_(BinaryReader &,
+                                   AutomorphismOptions const *) override
+  { return _automorphisms; }
+
   PermGroup _automorphisms;
 };
 
@@ -1,6 +1,7 @@
 #ifndef GUARD_ARCH_GRAPH_CLUSTER_H
 #define GUARD_ARCH_GRAPH_CLUSTER_H
 
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -9,6 +10,7 @@
 
 #include "arch_graph_system.hpp"
 #include "bsgs.hpp"
+#include "util.hpp"
 
 namespace mpsym
 {
@@ -64,6 +66,20 @@ private:
     }
   }
 
+  void init_repr_decomposition_(AutomorphismOptions const *options,
+                                internal::timeout::flag aborted) override
+  {
+    for (auto const &subsystem : _subsystems)
+      subsystem->init_repr(options, aborted);
+  }
+
+  void prepare_repr_(AutomorphismOptions const *options,
+                     internal::timeout::flag aborted) override
+  {
+    for (auto const &subsystem : _subsystems)
+      subsystem->prepare_repr(options, aborted);
+  }
+
   bool repr_ready_() const override
   {
     for (auto const &subsystem : _subsystems) {
@@ -80,11 +96,27 @@ private:
       subsystem->reset_repr();
   }
 
+  std::size_t memory_usage_() const override
+  {
+    return memory_usage_automorphisms() +
+           util::container_memory_usage(
+             _subsystems,
+             [](std::shared_ptr<ArchGraphSystem> const &subsystem)
+             { return subsystem->memory_usage(); });
+  }
+
   TaskMapping repr_(TaskMapping const &mapping,
                     ReprOptions const *options,
                     TMORs *orbits,
                     internal::timeout::flag aborted) override;
 
+  TaskMapping repr_prepared_(TaskMapping const &mapping,
+                             ReprOptions const *options,
+                             TMORs *orbits,
+                             internal::timeout::flag aborted) const override;
+
+  void snapshot_structure_(internal::BinaryWriter &writer) const override;
+
   std::vector<std::shared_ptr<ArchGraphSystem>> _subsystems;
 };
 
@@ -1,13 +1,18 @@
 #ifndef GUARD_ARCH_GRAPH_SYSTEM_H
 #define GUARD_ARCH_GRAPH_SYSTEM_H
 
+#include <cassert>
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <unordered_set>
+#include <vector>
 
 #include "bsgs.hpp"
 #include "perm_group.hpp"
+#include "progress.hpp"
 #include "string.hpp"
 #include "task_mapping.hpp"
 #include "task_mapping_orbit.hpp"
@@ -16,7 +21,37 @@
 namespace mpsym
 {
 
-using AutomorphismOptions = internal::BSGSOptions;
+namespace internal
+{
+
+class BinaryReader;
+class BinaryWriter;
+
+} // namespace internal
+
+struct AutomorphismOptions : public internal::BSGSOptions
+{
+  AutomorphismOptions() = default;
+
+  explicit AutomorphismOptions(internal::BSGSOptions const &bsgs_options)
+  : internal::BSGSOptions(bsgs_options)
+  {}
+
+  static AutomorphismOptions fill_defaults(AutomorphismOptions const *options)
+  {
+    static AutomorphismOptions default_options;
+    return options ? *options : default_options;
+  }
+
+  bool use_group_cache = false;
+  std::string group_cache_dir;
+
+  // failing to write entries to 'group_cache_dir' is not an error, this is
+  // called with a description of every such failure instead
+  std::function<void(std::string const &)> group_cache_error_callback;
+
+  bool decompose_repr = false;
+};
 
 struct ReprOptions
 {
@@ -50,6 +85,9 @@ struct ReprOptions
   unsigned local_search_append_generators = 0u;
   unsigned local_search_sa_iterations = 100u;
   double local_search_sa_T_init = 1.0;
+
+  internal::progress::Callback progress_callback;
+  unsigned progress_interval = 1000u; // milliseconds
 };
 
 class ArchGraphSystem
@@ -73,9 +111,48 @@ public:
     std::string const &json_file)
   { return from_json(util::read_file(json_file)); }
 
+  // restores systems written by to_binary (with their concrete type), plain
+  // BSGS binaries are loaded as explicit automorphism groups
+  static std::shared_ptr<ArchGraphSystem> from_binary(
+    char const *data,
+    std::size_t size,
+    AutomorphismOptions const *options = nullptr);
+
+  static std::shared_ptr<ArchGraphSystem> from_binary(
+    std::string const &binary,
+    AutomorphismOptions const *options = nullptr)
+  { return from_binary(binary.data(), binary.size(), options); }
+
+  static std::shared_ptr<ArchGraphSystem> from_binary_file(
+    std::string const &binary_file,
+    AutomorphismOptions const *options = nullptr);
+
+  static std::shared_ptr<ArchGraphSystem> from_snapshot(
+    char const *data,
+    std::size_t size,
+    AutomorphismOptions const *options = nullptr);
+
+  static std::shared_ptr<ArchGraphSystem> from_snapshot(
+    std::string const &snapshot,
+    AutomorphismOptions const *options = nullptr)
+  { return from_snapshot(snapshot.data(), snapshot.size(), options); }
+
   virtual std::string to_gap() const = 0;
   virtual std::string to_json() const = 0;
 
+  // binary representation of the system that also includes all automorphism
+  // and representative state determined so far
+  std::string to_snapshot() const;
+
+  // snapshot of the system after its automorphisms have been determined
+  std::string to_binary(
+    AutomorphismOptions const *options = nullptr,
+    internal::timeout::flag aborted = internal::timeout::unset())
+  {
+    automorphisms(options, aborted);
+    return to_snapshot();
+  }
+
   std::shared_ptr<ArchGraphSystem> expand_automorphisms() const;
 
   virtual unsigned num_processors() const
@@ -91,11 +168,18 @@ public:
   {
     _automorphisms_valid = false;
     _automorphisms_is_symmetric_valid = false;
+    _repr_decomposition.clear();
+    _repr_decomposition_ready = false;
   }
 
   virtual unsigned automorphisms_degree() const
   { return num_processors(); }
 
+  // approximate heap memory used by the system, its cached automorphisms and
+  // representative computation state, in bytes
+  std::size_t memory_usage() const
+  { return memory_usage_(); }
+
   internal::BSGS::order_type num_automorphisms(
     AutomorphismOptions const *options = nullptr,
     internal::timeout::flag aborted = internal::timeout::unset())
@@ -106,7 +190,7 @@ public:
     internal::timeout::flag aborted = internal::timeout::unset())
   {
     if (!automorphisms_ready()) {
-      _automorphisms = automorphisms_(options, aborted);
+      _automorphisms = automorphisms_cached(options, aborted);
       _automorphism_generators = _automorphisms.generators().with_inverses();
       _automorphisms_valid = true;
     }
@@ -123,22 +207,50 @@ public:
     return _automorphism_generators;
   }
 
+  // 'enumeration_aborted' (if given) is polled while the orbit is enumerated,
+  // independently of 'aborted' which only bounds determining automorphisms,
+  // a progress callback in 'options' is also passed on to the orbit
   TMO automorphisms_orbit(
     TaskMapping const &mapping,
     AutomorphismOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset());
+    internal::timeout::flag aborted = internal::timeout::unset(),
+    internal::timeout::flag enumeration_aborted = nullptr);
 
   void init_repr(
     AutomorphismOptions const *options = nullptr,
     internal::timeout::flag aborted = internal::timeout::unset())
   {
+    bool decompose = options && options->decompose_repr;
+
     if (!repr_ready_())
       init_repr_(options, aborted);
+    else if (decompose && !_repr_decomposition_ready)
+      init_repr_decomposition_(options, aborted);
+
+    // automorphisms may already have been determined without decomposition
+    if (decompose)
+      _repr_decomposition_ready = true;
   }
 
   bool repr_ready() const
   { return repr_ready_(); }
 
+  // like init_repr but also determines all state representatives are lazily
+  // computed from, afterwards (and until the next reset) repr_prepared may be
+  // called from several threads at once
+  void prepare_repr(
+    AutomorphismOptions const *options = nullptr,
+    internal::timeout::flag aborted = internal::timeout::unset())
+  {
+    init_repr(options, aborted);
+    prepare_repr_(options, aborted);
+  }
+
+  // number of factors representatives are determined over separately
+  // (zero if automorphisms have not been decomposed)
+  unsigned num_repr_factors() const
+  { return static_cast<unsigned>(_repr_decomposition.size()); }
+
   void reset_repr()
   { reset_repr_(); }
 
@@ -148,7 +260,7 @@ public:
     internal::timeout::flag aborted = internal::timeout::unset())
   {
     if (!repr_ready_())
-      init_repr();
+      init_repr(nullptr, aborted);
 
     return repr_(mapping, options, nullptr, aborted);
   }
@@ -160,7 +272,7 @@ public:
     internal::timeout::flag aborted = internal::timeout::unset())
   {
     if (!repr_ready_())
-      init_repr();
+      init_repr(nullptr, aborted);
 
     auto representative(repr_(mapping, options, &orbits, aborted));
 
@@ -169,6 +281,60 @@ public:
     return std::make_tuple(representative, ins.first, ins.second);
   }
 
+  // requires a preceding call to prepare_repr, never modifies the system
+  TaskMapping repr_prepared(
+    TaskMapping const &mapping,
+    ReprOptions const *options = nullptr,
+    internal::timeout::flag aborted = internal::timeout::unset()) const
+  {
+    assert(repr_ready_());
+
+    return repr_prepared_(mapping, options, nullptr, aborted);
+  }
+
+  std::tuple<TaskMapping, bool, unsigned> repr_prepared(
+    TaskMapping const &mapping,
+    TMORs &orbits,
+    ReprOptions const *options = nullptr,
+    internal::timeout::flag aborted = internal::timeout::unset()) const
+  {
+    assert(repr_ready_());
+
+    auto representative(repr_prepared_(mapping, options, &orbits, aborted));
+
+    auto ins(orbits.insert(representative));
+
+    return std::make_tuple(representative, ins.first, ins.second);
+  }
+
+  // representatives of 'num_mappings' task mappings of 'num_tasks' tasks each,
+  // read from and written to row major buffers which may alias, the rows are
+  // split between 'num_threads' threads (all available if zero)
+  void repr_batch(
+    unsigned const *mappings,
+    unsigned *representatives,
+    unsigned num_mappings,
+    unsigned num_tasks,
+    ReprOptions const *options = nullptr,
+    unsigned num_threads = 1u,
+    internal::timeout::flag aborted = internal::timeout::unset());
+
+protected:
+  void init_repr_decomposition(AutomorphismOptions const *options,
+                               internal::timeout::flag aborted);
+
+  // structures of the automorphism group shared with shared_with are not
+  // counted, e.g. if a subclass stores the automorphisms itself
+  std::size_t memory_usage_automorphisms(
+    internal::PermGroup const *shared_with = nullptr) const;
+
+  static void snapshot(ArchGraphSystem const &system,
+                       internal::BinaryWriter &writer);
+
+  static std::shared_ptr<ArchGraphSystem> restore(
+    internal::BinaryReader &reader,
+    AutomorphismOptions const *options);
+
 private:
   virtual internal::BSGS::order_type num_automorphisms_(
     AutomorphismOptions const *options,
@@ -179,11 +345,32 @@ private:
     AutomorphismOptions const *options,
     internal::timeout::flag aborted) = 0;
 
-  bool automorphisms_symmetric(ReprOptions const *options);
+  internal::PermGroup automorphisms_cached(
+    AutomorphismOptions const *options,
+    internal::timeout::flag aborted);
 
-  virtual void init_repr_(AutomorphismOptions const *,
-                          internal::timeout::flag )
-  {}
+  void init_automorphisms_symmetric();
+
+  bool automorphisms_symmetric(ReprOptions const *options) const
+  {
+    if (!options->optimize_symmetric)
+      return false;
+
+    assert(_automorphisms_is_symmetric_valid);
+
+    return _automorphisms_is_symmetric;
+  }
+
+  virtual void init_repr_(AutomorphismOptions const *options,
+                          internal::timeout::flag aborted)
+  { init_repr_decomposition(options, aborted); }
+
+  virtual void init_repr_decomposition_(AutomorphismOptions const *options,
+                                        internal::timeout::flag aborted)
+  { init_repr_decomposition(options, aborted); }
+
+  virtual void prepare_repr_(AutomorphismOptions const *options,
+                             internal::timeout::flag aborted);
 
   virtual bool repr_ready_() const
   { return automorphisms_ready(); }
@@ -191,11 +378,34 @@ private:
   virtual void reset_repr_()
   { reset_automorphisms(); }
 
+  virtual std::size_t memory_usage_() const
+  { return memory_usage_automorphisms(); }
+
+  virtual void snapshot_structure_(internal::BinaryWriter &writer) const = 0;
+
+  virtual void snapshot_automorphisms_(internal::BinaryWriter &writer) const;
+
+  virtual internal::PermGroup restore_automorphisms_(
+    internal::BinaryReader &reader,
+    AutomorphismOptions const *options);
+
+  virtual void snapshot_state_(internal::BinaryWriter &) const
+  {}
+
+  virtual void restore_state_(internal::BinaryReader &,
+                              AutomorphismOptions const *)
+  {}
+
   virtual TaskMapping repr_(TaskMapping const &mapping,
                             ReprOptions const *options,
                             TMORs *orbits,
                             internal::timeout::flag aborted);
 
+  virtual TaskMapping repr_prepared_(TaskMapping const &mapping,
+                                     ReprOptions const *options,
+                                     TMORs *orbits,
+                                     internal::timeout::flag aborted) const;
+
   static bool is_repr(TaskMapping const &tasks,
                       ReprOptions const *options,
                       TMORs *orbits)
@@ -206,6 +416,10 @@ private:
     return orbits->is_repr(tasks);
   }
 
+  TaskMapping repr_decomposed(TaskMapping const &mapping,
+                              ReprOptions const *options,
+                              internal::timeout::flag aborted) const;
+
   TaskMapping min_elem_iterate(TaskMapping const &tasks,
                                ReprOptions const *options,
                                TMORs *orbits,
@@ -217,12 +431,14 @@ private:
                               internal::timeout::flag aborted) const;
 
   TaskMapping min_elem_local_search(TaskMapping const &tasks,
-                                    ReprOptions const *options) const;
+                                    ReprOptions const *options,
+                                    internal::timeout::flag aborted) const;
 
   internal::PermSet local_search_augment_gens(ReprOptions const *options) const;
 
   TaskMapping min_elem_local_search_sa(TaskMapping const &tasks,
-                                       ReprOptions const *options) const;
+                                       ReprOptions const *options,
+                                       internal::timeout::flag aborted) const;
 
   static double local_search_sa_schedule_T(unsigned i,
                                            ReprOptions const *options);
@@ -244,6 +460,9 @@ private:
 
   unsigned _automorphisms_smp;
   unsigned _automorphisms_lmp;
+
+  std::vector<std::shared_ptr<ArchGraphSystem>> _repr_decomposition;
+  bool _repr_decomposition_ready = false;
 };
 
 } // namespace mpsym
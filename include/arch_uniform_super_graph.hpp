@@ -1,6 +1,7 @@
 #ifndef GUARD_ARCH_UNIFORM_SUPER_GRAPH_H
 #define GUARD_ARCH_UNIFORM_SUPER_GRAPH_H
 
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -64,15 +65,37 @@ private:
   void init_repr_(AutomorphismOptions const *options,
                   internal::timeout::flag aborted) override;
 
+  // representatives are determined via the wreath product action
+  void init_repr_decomposition_(AutomorphismOptions const *,
+                                internal::timeout::flag) override
+  {}
+
+  void prepare_repr_(AutomorphismOptions const *options,
+                     internal::timeout::flag aborted) override;
+
   bool repr_ready_() const override;
 
   void reset_repr_() override;
 
+  std::size_t memory_usage_() const override;
+
   TaskMapping repr_(TaskMapping const &mapping_,
                     ReprOptions const *options,
                     TMORs *orbits,
                     internal::timeout::flag aborted) override;
 
+  TaskMapping repr_prepared_(TaskMapping const &mapping,
+                             ReprOptions const *options,
+                             TMORs *orbits,
+                             internal::timeout::flag aborted) const override;
+
+  void snapshot_structure_(internal::BinaryWriter &writer) const override;
+
+  void snapshot_state_(internal::BinaryWriter &writer) const override;
+
+  void restore_state_(internal::BinaryReader &reader,
+                      AutomorphismOptions const *options) override;
+
   std::shared_ptr<internal::ArchGraphAutomorphisms>
   wreath_product_action_super_graph(AutomorphismOptions const *options,
                                     internal::timeout::flag aborted) const;
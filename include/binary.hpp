@@ -0,0 +1,141 @@
+#ifndef GUARD_BINARY_H
+#define GUARD_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "perm.hpp"
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+// Binary data is stored as a sequence of 32 bit words in native byte order,
+// strings are zero padded to a multiple of four bytes.
+
+class BinaryWriter
+{
+public:
+  using word = std::uint32_t;
+
+  void write(word w)
+  { _buf.append(reinterpret_cast<char const *>(&w), sizeof(word)); }
+
+  void write(char const *data, std::size_t size)
+  {
+    _buf.append(data, size);
+
+    if (size % sizeof(word) != 0u)
+      _buf.append(sizeof(word) - size % sizeof(word), '\0');
+  }
+
+  void write(Perm const &perm)
+  {
+    for (unsigned x = 0u; x < perm.degree(); ++x)
+      write(perm[x]);
+  }
+
+  // length prefixed
+  void write_string(std::string const &str)
+  {
+    write(static_cast<word>(str.size()));
+    write(str.data(), str.size());
+  }
+
+  std::string const &str() const
+  { return _buf; }
+
+private:
+  std::string _buf;
+};
+
+class BinaryReader
+{
+public:
+  using word = std::uint32_t;
+
+  BinaryReader(char const *data, std::size_t size)
+  : _data(data),
+    _size(size)
+  {}
+
+  word read()
+  {
+    word w;
+    std::memcpy(&w, consume(sizeof(word)), sizeof(word));
+
+    return w;
+  }
+
+  std::vector<unsigned> read(word n)
+  {
+    std::vector<unsigned> res(n);
+
+    if (n > 0u) {
+      auto src(consume(static_cast<std::size_t>(n) * sizeof(word)));
+
+      for (word i = 0u; i < n; ++i)
+        std::memcpy(&res[i], src + i * sizeof(word), sizeof(word));
+    }
+
+    return res;
+  }
+
+  std::string read_string(word length)
+  {
+    std::size_t padded = (length + sizeof(word) - 1u) / sizeof(word) * sizeof(word);
+
+    return std::string(consume(padded), length);
+  }
+
+  // length prefixed
+  std::string read_string()
+  { return read_string(read()); }
+
+  Perm read_perm(word degree)
+  {
+    auto images(read(degree));
+
+    std::vector<bool> seen(degree, false);
+
+    for (unsigned x : images) {
+      if (x >= degree || seen[x])
+        throw std::runtime_error("malformed binary data");
+
+      seen[x] = true;
+    }
+
+    return Perm(images);
+  }
+
+  bool done() const
+  { return _pos == _size; }
+
+private:
+  char const *consume(std::size_t n)
+  {
+    if (n > _size - _pos)
+      throw std::runtime_error("truncated binary data");
+
+    char const *res = _data + _pos;
+    _pos += n;
+
+    return res;
+  }
+
+  char const *_data;
+  std::size_t _size;
+  std::size_t _pos = 0u;
+};
+
+} // namespace internal
+
+} // namespace mpsym
+
+#endif // GUARD_BINARY_H
@@ -1,11 +1,14 @@
 #ifndef GUARD_BLOCK_SYSTEM_H
 #define GUARD_BLOCK_SYSTEM_H
 
+#include <cstddef>
 #include <initializer_list>
 #include <ostream>
 #include <vector>
 
+#include "memory.hpp"
 #include "perm.hpp"
+#include "timeout.hpp"
 
 namespace mpsym
 {
@@ -78,6 +81,15 @@ public:
 
   unsigned block_index(unsigned x) const;
 
+  std::size_t memory_usage() const
+  {
+    return util::container_memory_usage(
+             _blocks,
+             [](Block const &block)
+             { return util::container_memory_usage(block); }) +
+           util::container_memory_usage(_block_indices);
+  }
+
   PermSet block_permuter(PermSet const &generators) const;
 
   static PermSet block_stabilizers(PermSet const &generators,
@@ -86,8 +98,10 @@ public:
   static BlockSystem minimal(PermSet const &generators,
                              std::vector<unsigned> const &initial_block);
 
-  static std::vector<BlockSystem> non_trivial(PermGroup const &pg,
-                                              bool assume_transitivity = false);
+  static std::vector<BlockSystem> non_trivial(
+    PermGroup const &pg,
+    bool assume_transitivity = false,
+    timeout::flag aborted = timeout::unset());
 
 private:
   template<typename IT>
@@ -119,6 +133,12 @@ private:
 
   static BlockSystem from_block(PermSet const &generators, Block const &block);
 
+  static bool minimal_classpath(PermSet const &generators,
+                                std::vector<unsigned> const &initial_block,
+                                std::vector<unsigned> &classpath,
+                                std::vector<unsigned> &cardinalities,
+                                std::vector<unsigned> &queue);
+
   static unsigned minimal_find_rep(unsigned k,
                                    std::vector<unsigned> &classpath);
 
@@ -130,14 +150,25 @@ private:
 
   static void minimal_compress_classpath(std::vector<unsigned> &classpath);
 
-  static std::vector<BlockSystem> non_trivial_transitive(PermGroup const &pg);
+  static std::vector<BlockSystem> non_trivial_transitive(
+    PermGroup const &pg,
+    timeout::flag aborted);
+
+  static std::vector<std::vector<unsigned>> non_trivial_minimal_classpaths(
+    PermSet const &generators,
+    unsigned first_base_elem,
+    std::vector<unsigned> const &candidates,
+    timeout::flag aborted);
 
-  static std::vector<BlockSystem> non_trivial_non_transitive(PermGroup const &pg);
+  static std::vector<BlockSystem> non_trivial_non_transitive(
+    PermGroup const &pg,
+    timeout::flag aborted);
 
   static std::vector<Block> non_trivial_find_representatives(
     PermSet const &generators,
     std::vector<std::vector<BlockSystem>> const &partial_blocksystems,
-    std::vector<unsigned> const &domain_offsets);
+    std::vector<unsigned> const &domain_offsets,
+    timeout::flag aborted);
 
   static std::vector<BlockSystem> non_trivial_from_representatives(
     PermSet const &generators,
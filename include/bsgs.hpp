@@ -2,6 +2,7 @@
 #define GUARD_BSGS_H
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
 #include <ostream>
 #include <stdexcept>
@@ -13,6 +14,7 @@
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include "perm_set.hpp"
+#include "progress.hpp"
 #include "timeout.hpp"
 
 namespace mpsym
@@ -42,6 +44,9 @@ public:
   void insert_schreier_structure(
     unsigned i, unsigned root, unsigned degree, PermSet const &generators);
 
+  void restore_schreier_structure(
+    unsigned i, std::shared_ptr<SchreierStructure> ss);
+
   void clear()
   { _schreier_structures.clear(); }
 
@@ -74,6 +79,16 @@ public:
   using Base = std::vector<unsigned>;
   using order_type = boost::multiprecision::cpp_int;
 
+  struct LevelMemoryUsage
+  {
+    std::size_t transversals = 0u;
+    std::size_t labels = 0u;
+    std::size_t orbit = 0u;
+
+    std::size_t total() const
+    { return transversals + labels + orbit; }
+  };
+
   struct SolveError : public std::runtime_error
   {
     SolveError()
@@ -99,6 +114,22 @@ public:
        PermSet const &strong_generators,
        BSGSOptions const *options = nullptr);
 
+  static BSGS from_binary(char const *data,
+                          std::size_t size,
+                          BSGSOptions const *options = nullptr);
+
+  static BSGS from_binary(std::string const &binary,
+                          BSGSOptions const *options = nullptr)
+  { return from_binary(binary.data(), binary.size(), options); }
+
+  // fast load: the schreier structures are restored from the stored edges
+  // instead of being recomputed
+  static BSGS from_binary_file(std::string const &binary_file,
+                               BSGSOptions const *options = nullptr);
+
+  std::string to_binary() const;
+  void to_binary_file(std::string const &binary_file) const;
+
   unsigned degree() const { return _degree; }
   order_type order() const;
 
@@ -108,7 +139,8 @@ public:
   bool base_empty() const { return _base.empty(); }
   unsigned base_size() const { return _base.size(); }
   unsigned base_point(unsigned i) const { return _base[i]; }
-  void base_change(std::vector<unsigned> prefix);
+  void base_change(std::vector<unsigned> prefix,
+                   timeout::flag aborted = timeout::unset());
 
   PermSet strong_generators() const { return _strong_generators; }
   PermSet strong_generators(unsigned i) const;
@@ -120,6 +152,17 @@ public:
 
   std::pair<Perm, unsigned> strip(Perm const &perm, unsigned offs = 0) const;
   bool strips_completely(Perm const &perm) const;
+  std::vector<bool> strips_completely(PermSet const &perms,
+                                      unsigned num_threads = 0u) const;
+
+  // approximate heap memory used by the base, the strong generators, the
+  // schreier structures of every level and cached batch strip tables, in bytes
+  std::vector<LevelMemoryUsage> level_memory_usage() const;
+  std::size_t memory_usage() const;
+
+  // like memory_usage() but schreier structures shared with shared_with (of
+  // which this is e.g. a copy) are not counted
+  std::size_t memory_usage(BSGS const &shared_with) const;
 
 private:
   // transversal initialization
@@ -164,7 +207,7 @@ private:
   void schreier_sims_finish();
 
   // solvable BSGS initialization
-  void solve(PermSet const &generators);
+  void solve(PermSet const &generators, timeout::flag aborted);
 
   bool solve_s_normal_closure(PermSet const &generators,
                               Perm const &w,
@@ -173,7 +216,7 @@ private:
   void solve_adjoin_normalizing_generator(Perm const &gen);
 
   // generator reduction
-  void reduce_gens();
+  void reduce_gens(timeout::flag aborted);
 
   std::unordered_set<Perm> reduce_gens_set_difference(
     std::unordered_set<Perm> const &lhs,
@@ -186,6 +229,29 @@ private:
   unsigned insert_redundant_base_point(unsigned bp, unsigned i_min);
   void conjugate(Perm const &conj);
 
+  // batch stripping
+  struct StripTables
+  {
+    std::vector<std::vector<int>> orbit_indices;
+    std::vector<std::vector<unsigned>> inverse_transversals;
+  };
+
+  // built on the first batch strip and shared by copies, discarded as soon as
+  // the base changes
+  std::shared_ptr<StripTables const> strip_tables() const;
+  StripTables strip_tables_build() const;
+
+  std::size_t memory_usage_strip_tables() const;
+
+  void strip_tables_reset()
+  { std::atomic_store(&_strip_tables, std::shared_ptr<StripTables const>()); }
+
+  void strips_completely_batch(StripTables const &tables,
+                               PermSet const &perms,
+                               unsigned first,
+                               unsigned last,
+                               std::vector<char> &results) const;
+
   // convenience methods
   void extend_base(unsigned bp);
   void extend_base(unsigned bp, unsigned i);
@@ -219,6 +285,8 @@ private:
 
   bool _is_symmetric = false;
   bool _is_alternating = false;
+
+  mutable std::shared_ptr<StripTables const> _strip_tables;
 };
 
 std::ostream &operator<<(std::ostream &os, BSGS const &bsgs);
@@ -255,6 +323,9 @@ struct BSGSOptions
   BSGS::order_type schreier_sims_random_known_order = 0;
   int schreier_sims_random_retries = -1;
   unsigned schreier_sims_random_w = 100u;
+
+  progress::Callback progress_callback;
+  unsigned progress_interval = 1000u; // milliseconds
 };
 
 } // namespace internal
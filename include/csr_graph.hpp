@@ -0,0 +1,129 @@
+#ifndef GUARD_CSR_GRAPH_H
+#define GUARD_CSR_GRAPH_H
+
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include "memory.hpp"
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+// Immutable graph in compressed sparse row format, i.e. the out-neighbours of
+// all vertices stored contiguously in one array indexed by a second array of
+// offsets. Undirected edges are stored as two arcs.
+
+class CSRGraph
+{
+public:
+  // Passed to the arc enumeration function given to the constructor, which is
+  // called twice: once to count the out-degrees of all vertices and once to
+  // store the arcs in place, so no intermediate adjacency lists are needed.
+  // Both calls must enumerate the same arcs.
+  class Arcs
+  {
+    friend class CSRGraph;
+
+  public:
+    void operator()(int from, int to)
+    {
+      assert(from >= 0 && from < _graph->num_vertices());
+      assert(to >= 0 && to < _graph->num_vertices());
+
+      if (_store)
+        _graph->_targets[_next[from]++] = to;
+      else
+        ++_graph->_degrees[from];
+    }
+
+  private:
+    explicit Arcs(CSRGraph *graph)
+    : _graph(graph)
+    {}
+
+    CSRGraph *_graph;
+    bool _store = false;
+    std::vector<std::size_t> _next;
+  };
+
+  explicit CSRGraph(int n = 0)
+  : _offsets(n + 1, 0u),
+    _degrees(n, 0)
+  {}
+
+  template<typename FUNC>
+  CSRGraph(int n, FUNC &&for_each_arc)
+  : _offsets(n + 1, 0u),
+    _degrees(n, 0)
+  {
+    Arcs arcs(this);
+
+    for_each_arc(arcs);
+
+    std::partial_sum(_degrees.begin(), _degrees.end(), _offsets.begin() + 1);
+
+    _targets.resize(_offsets.back());
+
+    arcs._store = true;
+    arcs._next.assign(_offsets.begin(), _offsets.end() - 1);
+
+    for_each_arc(arcs);
+
+#ifndef NDEBUG
+    for (int v = 0; v < n; ++v)
+      assert(arcs._next[v] == _offsets[v + 1] && "arcs enumerated consistently");
+#endif
+  }
+
+  int num_vertices() const
+  { return static_cast<int>(_offsets.size()) - 1; }
+
+  std::size_t num_arcs() const
+  { return _targets.size(); }
+
+  std::size_t offset(int v) const
+  { return _offsets[v]; }
+
+  int degree(int v) const
+  { return _degrees[v]; }
+
+  int const *neighbours_begin(int v) const
+  { return _targets.data() + _offsets[v]; }
+
+  int const *neighbours_end(int v) const
+  { return _targets.data() + _offsets[v + 1]; }
+
+  // offsets (with one trailing entry equal to num_arcs()), degrees and targets
+  // have the layout of nauty's sparsegraph arrays v, d and e
+  std::vector<std::size_t> const &offsets() const
+  { return _offsets; }
+
+  std::vector<int> const &degrees() const
+  { return _degrees; }
+
+  std::vector<int> const &targets() const
+  { return _targets; }
+
+  std::size_t memory_usage() const
+  {
+    return util::container_memory_usage(_offsets) +
+           util::container_memory_usage(_degrees) +
+           util::container_memory_usage(_targets);
+  }
+
+private:
+  std::vector<std::size_t> _offsets;
+  std::vector<int> _degrees;
+  std::vector<int> _targets;
+};
+
+} // namespace internal
+
+} // namespace mpsym
+
+#endif // GUARD_CSR_GRAPH_H
@@ -11,6 +11,17 @@
 
 #define DBG_NS ::mpsym::internal::dbg
 
+// DBG statements below DBG_LEVEL_MIN are discarded at compile time, i.e. they
+// generate neither code nor branches, statements at or above it are filtered
+// at runtime according to DBG_SET_LOGLEVEL and DBG_SET_TRACE_SAMPLING
+#ifndef DBG_LEVEL_MIN
+#ifdef NDEBUG
+#define DBG_LEVEL_MIN 5 // OFF
+#else
+#define DBG_LEVEL_MIN 1 // TRACE
+#endif
+#endif
+
 namespace mpsym
 {
 
@@ -23,11 +34,27 @@ namespace dbg
 class Dbg
 {
 public:
-  enum { TRACE = 1, DEBUG = 2, INFO = 3, WARN = 4};
+  enum { TRACE = 1, DEBUG = 2, INFO = 3, WARN = 4, OFF = 5 };
 
   static int loglevel;
+  static unsigned trace_sampling;
   static std::ostream *out;
 
+  static bool enabled(int level)
+  {
+    if (level < loglevel)
+      return false;
+
+    // only emit every n-th trace statement (per thread), this keeps tracing
+    // cheap enough to be switched on in production builds
+    if (level != TRACE || trace_sampling <= 1u)
+      return true;
+
+    static thread_local unsigned trace_count = 0u;
+
+    return trace_count++ % trace_sampling == 0u;
+  }
+
   Dbg(int level = WARN)
   : _level(level)
   { _buf << _headers[_level]; }
@@ -81,16 +108,9 @@ private:
 
 } // namespace mpsym
 
-#ifdef NDEBUG
-
-#define DBG(level) if (0) DBG_NS :: Dbg()
-
-#define DBG_SET_LOGLEVEL(loglevel)
-
-#else
-
 #define DBG(level) \
-  if (level < DBG_NS :: Dbg::loglevel) {} \
+  if ((level) < DBG_LEVEL_MIN) {} \
+  else if (!DBG_NS :: Dbg::enabled(level)) {} \
   else DBG_NS :: Dbg(level)
 
 #define TRACE DBG_NS :: Dbg::TRACE
@@ -101,6 +121,7 @@ private:
 #define DBG_SET_LOGLEVEL(level) do { \
   DBG_NS :: Dbg::loglevel = level; } while (0)
 
-#endif
+#define DBG_SET_TRACE_SAMPLING(sampling) do { \
+  DBG_NS :: Dbg::trace_sampling = sampling; } while (0)
 
 #endif // GUARD_DBG_H
@@ -1,10 +1,12 @@
 #ifndef GUARD_EXPLICIT_TRANSVERSALS_H
 #define GUARD_EXPLICIT_TRANSVERSALS_H
 
+#include <cstddef>
 #include <map>
 #include <ostream>
 #include <vector>
 
+#include "memory.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
 #include "schreier_structure.hpp"
@@ -40,6 +42,21 @@ struct ExplicitTransversals : public SchreierStructure
   bool incoming(unsigned node, Perm const &edge) const override;
   Perm transversal(unsigned origin) const override;
 
+  std::size_t memory_usage_orbit() const override
+  { return util::container_memory_usage(_orbit); }
+
+  std::size_t memory_usage_transversals() const override
+  {
+    std::size_t res = 0u;
+    for (auto const &o : _orbit)
+      res += o.second.memory_usage();
+
+    return res;
+  }
+
+  std::size_t memory_usage_labels() const override
+  { return _labels.memory_usage(); }
+
 private:
   void dump(std::ostream &os) const override;
 
@@ -0,0 +1,141 @@
+#ifndef GUARD_INSTRUMENT_H
+#define GUARD_INSTRUMENT_H
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string>
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+namespace instrument
+{
+
+// statically registered probes, every probe counts its invocations, probes
+// instrumented with INSTRUMENT_SCOPE additionally record latency histograms
+
+enum Probe : unsigned
+{
+  STRIP,
+  SCHREIER_GENERATOR,
+  BASE_EXTENSION,
+  TRANSVERSAL,
+  REPR,
+  ORBIT_EXPANSION,
+  NUM_PROBES
+};
+
+// bucket k holds latencies in [2^(k-1), 2^k) nanoseconds
+enum : unsigned { NUM_BUCKETS = 40u };
+
+char const *probe_name(Probe probe);
+
+extern std::atomic<bool> _enabled;
+
+inline bool enabled()
+{ return _enabled.load(std::memory_order_relaxed); }
+
+void enable(bool enable = true);
+
+// resetting while other threads are instrumented may lose some of their
+// concurrent updates
+void reset();
+
+struct Counters
+{
+  unsigned long long count[NUM_PROBES];
+  unsigned long long total_ns[NUM_PROBES];
+  unsigned long long histogram[NUM_PROBES][NUM_BUCKETS];
+};
+
+// sum over all threads, including threads that have already exited
+Counters collect();
+
+void dump_text(std::ostream &os);
+std::string dump_json();
+
+// per-thread counters, only ever written by their owning thread so relaxed
+// loads and stores suffice while collect() can read them at any time
+
+struct ThreadCounters
+{
+  ThreadCounters();
+  ~ThreadCounters();
+
+  std::atomic<unsigned long long> count[NUM_PROBES];
+  std::atomic<unsigned long long> total_ns[NUM_PROBES];
+  std::atomic<unsigned long long> histogram[NUM_PROBES][NUM_BUCKETS];
+};
+
+ThreadCounters &_thread_counters();
+
+inline void _inc(std::atomic<unsigned long long> &c,
+                 unsigned long long delta = 1ULL)
+{ c.store(c.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed); }
+
+inline void count(Probe probe)
+{ _inc(_thread_counters().count[probe]); }
+
+void record(Probe probe, unsigned long long ns);
+
+class Scope
+{
+  using clock = std::chrono::steady_clock;
+
+public:
+  explicit Scope(Probe probe)
+  : _probe(probe),
+    _active(enabled())
+  {
+    if (_active)
+      _start = clock::now();
+  }
+
+  ~Scope()
+  {
+    if (!_active)
+      return;
+
+    auto ns(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      clock::now() - _start));
+
+    record(_probe, static_cast<unsigned long long>(ns.count()));
+  }
+
+private:
+  Probe _probe;
+  bool _active;
+  clock::time_point _start;
+};
+
+} // namespace instrument
+
+} // namespace internal
+
+} // namespace mpsym
+
+#ifdef NINSTRUMENT
+
+#define INSTRUMENT_COUNT(probe)
+#define INSTRUMENT_SCOPE(probe)
+
+#else
+
+#define INSTRUMENT_NS ::mpsym::internal::instrument
+
+#define INSTRUMENT_COUNT(probe) \
+  do { \
+    if (INSTRUMENT_NS :: enabled()) \
+      INSTRUMENT_NS :: count(INSTRUMENT_NS :: probe); \
+  } while (0)
+
+#define INSTRUMENT_SCOPE(probe) \
+  INSTRUMENT_NS :: Scope _instrument_scope_##probe(INSTRUMENT_NS :: probe)
+
+#endif
+
+#endif // GUARD_INSTRUMENT_H
@@ -0,0 +1,97 @@
+#ifndef GUARD_MEMORY_H
+#define GUARD_MEMORY_H
+
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace mpsym
+{
+
+namespace util
+{
+
+// Estimates of the heap memory (in bytes) allocated by standard library
+// containers. Node based containers are assumed to allocate one node per
+// element holding the element and a few bookkeeping words, which is close
+// enough to what libstdc++ and libc++ do for sizing purposes. Memory owned by
+// the elements themselves is only included if an element function is passed.
+
+template<typename T>
+std::size_t container_memory_usage(std::vector<T> const &v)
+{ return v.capacity() * sizeof(T); }
+
+template<typename T, typename FUNC>
+std::size_t container_memory_usage(std::vector<T> const &v, FUNC &&f)
+{
+  std::size_t res = container_memory_usage(v);
+  for (auto const &x : v)
+    res += f(x);
+
+  return res;
+}
+
+template<typename K, typename V>
+std::size_t container_memory_usage(std::map<K, V> const &m)
+{
+  // red-black tree nodes: color, parent, left and right child
+  return m.size() * (sizeof(typename std::map<K, V>::value_type)
+                     + 4u * sizeof(void *));
+}
+
+template<typename K, typename V, typename FUNC>
+std::size_t container_memory_usage(std::map<K, V> const &m, FUNC &&f)
+{
+  std::size_t res = container_memory_usage(m);
+  for (auto const &kv : m)
+    res += f(kv);
+
+  return res;
+}
+
+template<typename C>
+std::size_t hash_container_memory_usage(C const &c)
+{
+  // singly linked nodes with cached hash values plus bucket array
+  return c.bucket_count() * sizeof(void *)
+         + c.size() * (sizeof(typename C::value_type)
+                       + sizeof(void *) + sizeof(std::size_t));
+}
+
+template<typename K, typename V, typename H>
+std::size_t container_memory_usage(std::unordered_map<K, V, H> const &m)
+{ return hash_container_memory_usage(m); }
+
+template<typename K, typename V, typename H, typename FUNC>
+std::size_t container_memory_usage(std::unordered_map<K, V, H> const &m,
+                                   FUNC &&f)
+{
+  std::size_t res = hash_container_memory_usage(m);
+  for (auto const &kv : m)
+    res += f(kv);
+
+  return res;
+}
+
+template<typename T, typename H>
+std::size_t container_memory_usage(std::unordered_set<T, H> const &s)
+{ return hash_container_memory_usage(s); }
+
+template<typename T, typename H, typename FUNC>
+std::size_t container_memory_usage(std::unordered_set<T, H> const &s,
+                                   FUNC &&f)
+{
+  std::size_t res = hash_container_memory_usage(s);
+  for (auto const &x : s)
+    res += f(x);
+
+  return res;
+}
+
+} // namespace util
+
+} // namespace mpsym
+
+#endif // GUARD_MEMORY_H
@@ -1,11 +1,10 @@
 #ifndef GUARD_NAUTY_GRAPH_H
 #define GUARD_NAUTY_GRAPH_H
 
-#include <map>
 #include <string>
-#include <utility>
 #include <vector>
 
+#include "csr_graph.hpp"
 #include "perm_set.hpp"
 
 namespace mpsym
@@ -17,29 +16,25 @@ namespace internal
 class NautyGraph
 {
 public:
-  NautyGraph(int n, bool directed)
-  : NautyGraph(n, n, directed)
-  {}
-
-  NautyGraph(int n, int n_reduced, bool directed);
+  // undirected graphs must contain both arcs for every edge, automorphisms
+  // are restricted to the first n_reduced vertices (all if zero)
+  NautyGraph(CSRGraph graph, bool directed, int n_reduced = 0);
 
   ~NautyGraph();
 
   std::string to_gap() const;
 
-  void add_edge(int from, int to);
-  void add_edges(std::map<int, std::vector<int>> const &adj);
-
   void set_partition(std::vector<std::vector<int>> const &ptn);
 
-  PermSet automorphism_generators();
+  PermSet automorphism_generators(std::string *certificate = nullptr,
+                                  std::vector<int> *canonical_labeling = nullptr);
 
 private:
   bool _directed;
   int _n, _n_reduced;
   int *_lab, *_ptn, *_orbits;
 
-  std::vector<std::pair<int, int>> _edges;
+  CSRGraph _graph;
   std::vector<std::vector<int>> _ptn_expl;
 };
 
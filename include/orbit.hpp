@@ -2,6 +2,8 @@
 #define GUARD_ORBIT_H
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 #include <memory>
 #include <ostream>
@@ -9,6 +11,7 @@
 #include <vector>
 
 #include "dump.hpp"
+#include "memory.hpp"
 
 namespace mpsym
 {
@@ -16,11 +19,13 @@ namespace mpsym
 namespace internal
 {
 
+class Perm;
 class PermSet;
 class SchreierStructure;
 
 class Orbit
 {
+  friend class OrbitPartition;
   friend std::ostream &operator<<(std::ostream &os, Orbit const &o);
 
 public:
@@ -34,12 +39,12 @@ public:
 
   Orbit(std::initializer_list<unsigned> elements)
   : _elements(elements)
-  {}
+  { update_members(); }
 
   template<typename IT>
   Orbit(IT first, IT last)
   : _elements(first, last)
-  {}
+  { update_members(); }
 
   static Orbit generate(unsigned x,
                         PermSet const &generators,
@@ -58,24 +63,31 @@ public:
               std::shared_ptr<SchreierStructure> ss = nullptr);
 
   void insert(unsigned x)
-  { _elements.push_back(x); }
+  {
+    _elements.push_back(x);
+
+    if (_indexed)
+      add_member(x);
+  }
 
   template<typename IT>
   bool erase(unsigned x)
   {
-    for (auto it = begin(); it != end(); ++it) {
-      if (*it == x) {
-        erase(it);
-        return true;
-      }
-    }
-
-    return false;
+    if (!contains(x))
+      return false;
+
+    erase(std::find(begin(), end(), x));
+    return true;
   }
 
   template<typename IT>
   IT erase(IT it)
-  { return _elements.erase(it); }
+  {
+    if (_indexed)
+      remove_member(*it);
+
+    return _elements.erase(it);
+  }
 
   bool empty() const
   { return _elements.empty(); }
@@ -90,15 +102,82 @@ public:
   { return _elements.end(); }
 
   bool contains(unsigned x) const
-  { return std::find(begin(), end(), x) != end(); }
+  {
+    if (x / MEMBER_BITS < _members.size())
+      return (_members[x / MEMBER_BITS] >> (x % MEMBER_BITS)) & 1u;
+
+    // orbits without membership bitset (see unindex) are searched linearly,
+    // use OrbitPartition::partition_index to test membership in those
+    return !_indexed && std::find(begin(), end(), x) != end();
+  }
+
+  std::size_t memory_usage() const
+  {
+    return util::container_memory_usage(_elements) +
+           util::container_memory_usage(_members);
+  }
 
 private:
+  using member_word = std::uint64_t;
+
+  static constexpr unsigned MEMBER_BITS = 64u;
+
+  void reserve_members(unsigned degree)
+  {
+    auto words = (degree + MEMBER_BITS - 1u) / MEMBER_BITS;
+
+    if (_members.size() < words)
+      _members.resize(words, 0u);
+  }
+
+  void add_member(unsigned x)
+  {
+    reserve_members(x + 1u);
+    _members[x / MEMBER_BITS] |= member_word(1u) << (x % MEMBER_BITS);
+  }
+
+  void remove_member(unsigned x)
+  { _members[x / MEMBER_BITS] &= ~(member_word(1u) << (x % MEMBER_BITS)); }
+
+  void update_members()
+  {
+    for (unsigned x : _elements)
+      add_member(x);
+  }
+
+  // orbits belonging to an orbit partition don't keep a membership bitset
+  // since each would be sized by its largest element, i.e. the bitsets of a
+  // partition would take up quadratic space, the partition itself already maps
+  // points to orbits
+  void unindex()
+  {
+    if (!_indexed)
+      return;
+
+    _indexed = false;
+    _members = std::vector<member_word>();
+  }
+
+  void index()
+  {
+    if (_indexed)
+      return;
+
+    _indexed = true;
+    update_members();
+  }
+
   void extend(PermSet const &generators,
               std::vector<unsigned> stack,
-              std::unordered_set<unsigned> done,
               std::shared_ptr<SchreierStructure> ss);
 
   std::vector<unsigned> _elements;
+
+  // dense membership bitset, kept alongside the elements for constant time
+  // (and word parallel) membership and equality tests, except for orbits
+  // belonging to an orbit partition
+  std::vector<member_word> _members;
+  bool _indexed = true;
 };
 
 inline std::ostream &operator<<(std::ostream &os, Orbit const &orbit)
@@ -130,6 +209,15 @@ public:
 
   std::vector<OrbitPartition> split(OrbitPartition const &split) const;
 
+  // coarsen the partition such that it is also invariant under 'generator',
+  // points not contained in any partition are treated as fixed points
+  void add_generator(Perm const &generator);
+
+  // merge each given pair of partitions, partitions stay ordered by their
+  // smallest element
+  void merge_partitions(
+    std::vector<std::pair<unsigned, unsigned>> const &merges);
+
   unsigned num_partitions() const
   { return static_cast<unsigned>(_partitions.size()); }
 
@@ -150,12 +238,31 @@ public:
   { return _partitions.end(); }
 
 private:
+  static std::vector<unsigned> union_find_init(unsigned degree);
+
+  static unsigned union_find_find(unsigned x, std::vector<unsigned> &classes);
+
+  static bool union_find_union(unsigned x,
+                               unsigned y,
+                               std::vector<unsigned> &classes);
+
+  static unsigned union_find_merge(Perm const &generator,
+                                   std::vector<unsigned> &classes);
+
+  void union_find_sync();
+  void union_find_apply(bool all_points);
+
   void add_to_partition(unsigned x, int i);
   void update_partitions();
   void update_partition_indices();
 
   std::vector<Orbit> _partitions;
   std::vector<int> _partition_indices;
+
+  // union-find structure over all points whose classes are the partitions
+  // (and fixed points), kept so that partitions can be coarsened
+  // incrementally, empty if it has to be rebuilt from the partitions
+  std::vector<unsigned> _classes;
 };
 
 inline std::ostream &operator<<(std::ostream &os, OrbitPartition const &op)
@@ -8,6 +8,8 @@
 
 #include <boost/operators.hpp>
 
+#include "memory.hpp"
+
 namespace mpsym
 {
 
@@ -81,17 +83,27 @@ public:
   template<typename IT>
   Perm restricted(IT first, IT last) const
   {
-    std::vector<std::vector<unsigned>> restricted_cycles;
+    std::vector<char> domain(degree(), 0);
 
-    for (auto const &cycle : cycles()) {
-      bool restrict = false;
+    for (IT it = first; it != last; ++it) {
+      unsigned x = *it;
+
+      if (x < degree())
+        domain[x] = 1;
+    }
 
-      for (unsigned x : cycle) {
-        if (std::find(first, last, x) == last)
-          restrict = true;
-      }
+    return restricted_if([&](unsigned x){ return domain[x] != 0; });
+  }
+
+  // restriction to all cycles consisting of points x for which in_domain(x)
+  // holds, e.g. for domains given by an orbit partition
+  template<typename FUNC>
+  Perm restricted_if(FUNC in_domain) const
+  {
+    std::vector<std::vector<unsigned>> restricted_cycles;
 
-      if (!restrict)
+    for (auto const &cycle : cycles()) {
+      if (std::all_of(cycle.begin(), cycle.end(), in_domain))
         restricted_cycles.push_back(cycle);
     }
 
@@ -103,6 +115,9 @@ public:
 
   std::vector<std::vector<unsigned>> cycles() const;
 
+  std::size_t memory_usage() const
+  { return util::container_memory_usage(_perm); }
+
 private:
   unsigned _degree;
   std::vector<unsigned> _perm;
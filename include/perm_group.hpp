@@ -2,7 +2,10 @@
 #define GUARD_PERM_GROUP_H
 
 #include <cassert>
+#include <cstddef>
 #include <map>
+#include <memory>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <vector>
@@ -165,12 +168,30 @@ public:
   bool is_transitive() const;
 
   bool contains_element(Perm const &perm) const;
+  std::vector<bool> contains_elements(PermSet const &perms,
+                                      unsigned num_threads = 0u) const;
   Perm random_element() const;
 
+  std::string fingerprint() const;
+
+  // approximate heap memory used by the BSGS and cached block systems, in bytes
+  std::size_t memory_usage() const;
+
+  // like memory_usage() but structures shared with shared_with (of which this
+  // is e.g. a copy) are not counted
+  std::size_t memory_usage(PermGroup const &shared_with) const;
+
+  std::vector<BlockSystem> block_systems(
+    timeout::flag aborted = timeout::unset()) const;
+
   std::vector<PermGroup> disjoint_decomposition(
-    bool complete = true, bool disjoint_orbit_optimization = false) const;
+    bool complete = true,
+    bool disjoint_orbit_optimization = false,
+    BSGSOptions const *options = nullptr,
+    timeout::flag aborted = timeout::unset()) const;
 
-  std::vector<PermGroup> wreath_decomposition() const;
+  std::vector<PermGroup> wreath_decomposition(
+    timeout::flag aborted = timeout::unset()) const;
 
 private:
   static boost::multiprecision::cpp_int symmetric_order(unsigned deg)
@@ -184,27 +205,43 @@ private:
 
   // complete disjoint decomposition
   bool disjoint_decomp_orbits_dependent(
-    Orbit const &orbit1,
-    Orbit const &orbit2) const;
+    OrbitPartition const &orbits,
+    unsigned i,
+    unsigned j,
+    timeout::Poll &poll) const;
 
   void disjoint_decomp_generate_dependency_classes(
-    OrbitPartition &orbits) const;
+    OrbitPartition &orbits,
+    timeout::flag aborted) const;
 
   static bool disjoint_decomp_restricted_subgroups(
     OrbitPartition const &orbit_split,
     PermGroup const &perm_group,
+    BSGSOptions const *options,
     std::pair<PermGroup, PermGroup> &restricted_subgroups);
 
+  static PermGroup disjoint_decomp_restricted_subgroup(
+    OrbitPartition const &orbit_split,
+    int split,
+    PermGroup const &perm_group,
+    PermSet const &restricted_generators,
+    BSGSOptions const *options);
+
   static std::vector<PermGroup> disjoint_decomp_join_results(
     std::vector<PermGroup> const &res1,
     std::vector<PermGroup> const &res2);
 
   static std::vector<PermGroup> disjoint_decomp_complete_recursive(
     OrbitPartition const &orbits,
-    PermGroup const &perm_group);
+    PermGroup const &perm_group,
+    BSGSOptions const *options,
+    timeout::flag aborted,
+    unsigned parallel_depth = 0u);
 
   std::vector<PermGroup> disjoint_decomp_complete(
-    bool disjoint_orbit_optimization = true) const;
+    bool disjoint_orbit_optimization,
+    BSGSOptions const *options,
+    timeout::flag aborted) const;
 
   // incomplete disjoint decomposition
   struct MovedSet : public std::vector<unsigned>
@@ -232,7 +269,8 @@ private:
   void disjoint_decomp_merge_equivalence_classes(
     std::vector<EquivalenceClass> &equivalence_classes) const;
 
-  std::vector<PermGroup> disjoint_decomp_incomplete() const;
+  std::vector<PermGroup> disjoint_decomp_incomplete(
+    BSGSOptions const *options) const;
 
   // wreath decomposition
   std::vector<PermGroup> wreath_decomp_find_stabilizers(
@@ -250,6 +288,46 @@ private:
 
   BSGS _bsgs;
   BSGS::order_type _order;
+
+  // block systems only depend on the group so all copies share them, the
+  // cache itself is only allocated once the block systems are first
+  // determined or the group is first copied
+  class BlockSystemsCache
+  {
+  public:
+    using block_systems_type = std::shared_ptr<std::vector<BlockSystem> const>;
+
+    BlockSystemsCache() = default;
+
+    BlockSystemsCache(BlockSystemsCache const &other)
+    : _shared(other.shared())
+    {}
+
+    BlockSystemsCache(BlockSystemsCache &&other) = default;
+
+    BlockSystemsCache &operator=(BlockSystemsCache const &other)
+    {
+      _shared = other.shared();
+      return *this;
+    }
+
+    BlockSystemsCache &operator=(BlockSystemsCache &&other) = default;
+
+    block_systems_type load() const;
+
+    // returns the block systems published first, either by this call or by a
+    // concurrent one
+    block_systems_type publish(block_systems_type block_systems) const;
+
+    bool shared_with(BlockSystemsCache const &other) const;
+
+  private:
+    std::shared_ptr<block_systems_type> shared() const;
+
+    mutable std::shared_ptr<block_systems_type> _shared;
+  };
+
+  BlockSystemsCache _block_systems_cache;
 };
 
 std::ostream &operator<<(std::ostream &os, PermGroup const &pg);
@@ -0,0 +1,75 @@
+#ifndef GUARD_PERM_GROUP_CACHE_H
+#define GUARD_PERM_GROUP_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+#include "bsgs.hpp"
+#include "perm_group.hpp"
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+class PermGroupCache
+{
+public:
+  using group_ptr = std::shared_ptr<PermGroup const>;
+
+  static PermGroupCache &global();
+
+  // null if no group is cached under the given key
+  group_ptr find(std::string const &key) const;
+
+  // returns the group actually stored, i.e. pg or an equal group cached
+  // before (under a different key)
+  group_ptr insert(std::string const &key, PermGroup const &pg);
+
+  unsigned num_keys() const;
+  unsigned num_groups() const;
+
+  void clear();
+
+private:
+  mutable std::mutex _mutex;
+
+  std::unordered_map<std::string, group_ptr> _groups_by_key;
+  std::unordered_multimap<std::string, group_ptr> _groups_by_fingerprint;
+};
+
+class PermGroupDiskCache
+{
+public:
+  static constexpr unsigned VERSION = 1u;
+
+  explicit PermGroupDiskCache(std::string const &dir)
+  : _dir(dir)
+  {}
+
+  boost::optional<BSGS> load(std::string const &key,
+                             BSGSOptions const *options = nullptr) const;
+
+  // best effort, returns false on failure (e.g. read-only cache directories or
+  // full disks) in which case no (partial) entry is left behind and 'error'
+  // (if given) describes what went wrong
+  bool store(std::string const &key,
+             BSGS const &bsgs,
+             std::string *error = nullptr) const;
+
+private:
+  std::string path(std::string const &key) const;
+
+  std::string _dir;
+};
+
+} // namespace internal
+
+} // namespace mpsym
+
+#endif // GUARD_PERM_GROUP_CACHE_H
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <initializer_list>
 #include <ostream>
 #include <sstream>
@@ -10,6 +11,7 @@
 #include <vector>
 
 #include "dump.hpp"
+#include "memory.hpp"
 #include "perm.hpp"
 
 namespace mpsym
@@ -180,6 +182,12 @@ public:
 
   void insert_inverses();
 
+  std::size_t memory_usage() const
+  {
+    return util::container_memory_usage(
+      _perms, [](Perm const &perm){ return perm.memory_usage(); });
+  }
+
   PermSet with_inverses() const
   {
     if (has_inverses())
@@ -23,11 +23,15 @@ public:
   bool test_symmetric(double epsilon = 1e-6);
 
 private:
+  Perm shuffle();
+
   bool test_altsym(double epsilon);
   bool generators_even();
 
   PermSet _gens_orig;
   PermSet _gens;
+
+  unsigned _warmup;
 };
 
 } // namespace internal
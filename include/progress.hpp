@@ -0,0 +1,120 @@
+#ifndef GUARD_PROGRESS_H
+#define GUARD_PROGRESS_H
+
+#include <chrono>
+#include <functional>
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+namespace progress
+{
+
+enum class Phase
+{
+  SCHREIER_SIMS,
+  SCHREIER_SIMS_RANDOM,
+  REPR_ITERATE,
+  REPR_ORBITS,
+  REPR_LOCAL_SEARCH,
+  REPR_LOCAL_SEARCH_SA,
+  ORBIT_ENUMERATION
+};
+
+char const *phase_name(Phase phase);
+
+// snapshot of a long running computation, fields that don't apply to the
+// current phase are left at zero, 'remaining' is a phase specific estimate of
+// the work left (levels, sifts, group elements, queued mappings or iterations)
+// and negative if no such estimate is available, while enumerating orbits
+// 'elements' counts the orbit elements enumerated so far
+
+struct State
+{
+  Phase phase;
+
+  unsigned base_size = 0u;
+  unsigned level = 0u;
+
+  unsigned long long schreier_generators = 0ULL;
+  unsigned long long elements = 0ULL;
+
+  unsigned long long processed = 0ULL;
+  double remaining = -1.0;
+
+  bool finished = false;
+};
+
+using Callback = std::function<void(State const &)>;
+
+// rate limited progress reporting, the clock is only read on every
+// 'POLL_INTERVAL'-th tick and the callback is invoked at most once per
+// 'interval' milliseconds, without a callback ticks reduce to a single branch,
+// the callback must outlive the reporter
+
+class Reporter
+{
+  using clock = std::chrono::steady_clock;
+
+public:
+  enum : unsigned { POLL_INTERVAL = 64u };
+
+  Reporter(Callback const &callback, Phase phase, unsigned interval)
+  : _callback(callback ? &callback : nullptr),
+    _interval(std::chrono::milliseconds(interval)),
+    _countdown(POLL_INTERVAL),
+    _last(clock::now())
+  { state.phase = phase; }
+
+  State state;
+
+  // whether progress is reported at all, estimates which are expensive to
+  // compute should only be determined if so
+  bool active() const
+  { return _callback != nullptr; }
+
+  void tick()
+  {
+    ++state.processed;
+
+    if (!_callback || --_countdown > 0u)
+      return;
+
+    _countdown = POLL_INTERVAL;
+
+    auto now(clock::now());
+
+    if (now - _last >= _interval) {
+      _last = now;
+      (*_callback)(state);
+    }
+  }
+
+  void finish()
+  {
+    if (!_callback)
+      return;
+
+    state.remaining = 0.0;
+    state.finished = true;
+
+    (*_callback)(state);
+  }
+
+private:
+  Callback const *_callback;
+  clock::duration _interval;
+  unsigned _countdown;
+  clock::time_point _last;
+};
+
+} // namespace progress
+
+} // namespace internal
+
+} // namespace mpsym
+
+#endif // GUARD_PROGRESS_H
@@ -1,6 +1,7 @@
 #ifndef GUARD_SCHREIER_STRUCTURE_H
 #define GUARD_SCHREIER_STRUCTURE_H
 
+#include <cstddef>
 #include <ostream>
 #include <vector>
 
@@ -34,6 +35,19 @@ struct SchreierStructure
   virtual bool incoming(unsigned node, Perm const &edge) const = 0;
   virtual Perm transversal(unsigned origin) const = 0;
 
+  // heap memory used by the orbit, the transversals (i.e. explicit coset
+  // representatives or tree edges) and the edge labels
+  virtual std::size_t memory_usage_orbit() const = 0;
+  virtual std::size_t memory_usage_transversals() const = 0;
+  virtual std::size_t memory_usage_labels() const = 0;
+
+  std::size_t memory_usage() const
+  {
+    return memory_usage_orbit() +
+           memory_usage_transversals() +
+           memory_usage_labels();
+  }
+
 private:
   virtual void dump(std::ostream& os) const = 0;
 };
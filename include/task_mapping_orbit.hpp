@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <unordered_map>
@@ -10,8 +11,12 @@
 #include <utility>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "perm_set.hpp"
+#include "progress.hpp"
 #include "task_mapping.hpp"
+#include "timeout.hpp"
 #include "util.hpp"
 
 namespace mpsym
@@ -27,12 +32,19 @@ class TMO
     IterationState(TMO const *orbit)
     : _singular(orbit->_generators.empty()),
       _generators(&orbit->_generators),
+      _aborted(orbit->_aborted),
+      _progress(orbit->_progress_callback,
+                internal::progress::Phase::ORBIT_ENUMERATION,
+                orbit->_progress_interval),
       _unprocessed{orbit->_root}
     {
       current = _unprocessed.begin();
 
       if (!_singular)
         init_hash(orbit->_root);
+
+      if (_aborted)
+        _poll.emplace(_aborted);
     }
 
     std::unordered_set<TaskMapping>::iterator current;
@@ -40,6 +52,16 @@ class TMO
     void advance();
     bool exhausted() const;
 
+    std::size_t memory_usage() const
+    {
+      return util::container_memory_usage(_hash_support_map) +
+             util::container_memory_usage(
+               _unprocessed,
+               [](TaskMapping const &mapping)
+               { return util::container_memory_usage(mapping); }) +
+             util::container_memory_usage(_processed);
+    }
+
   private:
     void init_hash(TaskMapping const &root);
     hash_type perfect_hash(TaskMapping const &mapping) const;
@@ -48,6 +70,11 @@ class TMO
     bool _singular;
     internal::PermSet const *_generators;
 
+    internal::timeout::flag _aborted;
+    boost::optional<internal::timeout::Poll> _poll;
+
+    internal::progress::Reporter _progress;
+
     std::function<hash_type(TaskMapping)> _hash;
     std::unordered_map<unsigned, unsigned> _hash_support_map;
 
@@ -69,6 +96,10 @@ public:
     bool operator==(const_iterator const &rhs) const override
     { return end() && rhs.end(); }
 
+    // memory used by the state of an ongoing orbit enumeration
+    std::size_t memory_usage() const
+    { return _state ? _state->memory_usage() : 0u; }
+
   private:
     reference current() override
     { return *_state->current; }
@@ -82,9 +113,14 @@ public:
     std::shared_ptr<IterationState> _state;
   };
 
-  TMO(TaskMapping const &mapping, internal::PermSet const &generators)
+  // if 'aborted' is given, advancing an iterator over the orbit throws an
+  // AbortedError once it is set
+  TMO(TaskMapping const &mapping,
+      internal::PermSet const &generators,
+      internal::timeout::flag aborted = nullptr)
   : _root(mapping),
-    _generators(generators)
+    _generators(generators),
+    _aborted(aborted)
   {
 #ifndef NDEBUG
     if (!generators.empty()) {
@@ -102,9 +138,28 @@ public:
   const_iterator end() const
   { return const_iterator(); }
 
+  // report the number of orbit elements enumerated (and queued) by iterators
+  // over this orbit at most every 'interval' milliseconds
+  void set_progress_callback(internal::progress::Callback const &callback,
+                             unsigned interval = 1000u)
+  {
+    _progress_callback = callback;
+    _progress_interval = interval;
+  }
+
+  std::size_t memory_usage() const
+  {
+    return util::container_memory_usage(_root) +
+           _generators.memory_usage();
+  }
+
 private:
   TaskMapping _root;
   internal::PermSet _generators;
+  internal::timeout::flag _aborted;
+
+  internal::progress::Callback _progress_callback;
+  unsigned _progress_interval = 1000u;
 };
 
 class TMORs
@@ -158,6 +213,14 @@ public:
   unsigned num_orbits() const
   { return static_cast<unsigned>(_orbit_reprs.size()); }
 
+  std::size_t memory_usage() const
+  {
+    return util::container_memory_usage(
+      _orbit_reprs,
+      [](orbit_reprs_map::value_type const &repr)
+      { return util::container_memory_usage(repr.first); });
+  }
+
   const_iterator begin() const
   { return const_iterator(_orbit_reprs.begin()); }
 
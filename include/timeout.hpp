@@ -4,6 +4,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
 #include <memory>
@@ -12,8 +13,6 @@
 #include <thread>
 #include <utility>
 
-#include <boost/optional.hpp>
-
 namespace mpsym
 {
 
@@ -23,7 +22,7 @@ namespace internal
 namespace timeout
 {
 
-// keep track of and wait for termination of detached threads
+// keep track of and wait for termination of timed out calls
 
 extern std::atomic<int> _timeout_thread_count;
 extern std::condition_variable _timeout_thread_count_cv;
@@ -62,18 +61,136 @@ struct AbortedError : public std::runtime_error
   {}
 };
 
-// timeout function wrappers
+// cancellation tokens, optionally carrying a deadline after which they count
+// as set without anyone having to set them explicitly
+
+struct Token
+{
+  using clock = std::chrono::steady_clock;
+
+  Token()
+  : aborted(false),
+    has_deadline(false)
+  {}
+
+  template<typename REP, typename PERIOD>
+  Token(std::chrono::duration<REP, PERIOD> const &timeout)
+  : aborted(false),
+    has_deadline(true),
+    deadline(clock::now() +
+             std::chrono::duration_cast<clock::duration>(timeout))
+  {}
 
-using flag = std::shared_ptr<std::atomic<bool>>;
+  std::atomic<bool> aborted;
+  bool has_deadline;
+  clock::time_point deadline;
+};
+
+using flag = std::shared_ptr<Token>;
 
 inline flag unset()
-{ return std::make_shared<std::atomic<bool>>(false); }
+{ return std::make_shared<Token>(); }
+
+template<typename REP, typename PERIOD>
+flag unset(std::chrono::duration<REP, PERIOD> const &timeout)
+{ return std::make_shared<Token>(timeout); }
 
 inline void set(flag const &f)
-{ f->store(true); }
+{ f->aborted.store(true); }
+
+inline bool is_set(Token &token)
+{
+  if (token.aborted.load(std::memory_order_relaxed))
+    return true;
+
+  if (token.has_deadline && Token::clock::now() >= token.deadline) {
+    token.aborted.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+  return false;
+}
 
 inline bool is_set(flag const &f)
-{ return f->load(); }
+{ return is_set(*f); }
+
+inline void check(flag const &f, char const *what)
+{
+  if (is_set(f))
+    throw AbortedError(what);
+}
+
+// amortized cancellation checks for long running loops, the token (and its
+// deadline) is only consulted on every 'interval'-th call, the flag the poll
+// is constructed from must outlive it
+
+class Poll
+{
+public:
+  enum : unsigned { DEFAULT_INTERVAL = 64u };
+
+  explicit Poll(flag const &f, unsigned interval = DEFAULT_INTERVAL)
+  : _token(f.get()),
+    _interval(interval),
+    _countdown(interval)
+  {}
+
+  bool expired()
+  {
+    if (--_countdown > 0u)
+      return false;
+
+    _countdown = _interval;
+
+    return is_set(*_token);
+  }
+
+  void operator()(char const *what)
+  {
+    if (expired())
+      throw AbortedError(what);
+  }
+
+private:
+  Token *_token;
+  unsigned _interval;
+  unsigned _countdown;
+};
+
+// persistent worker threads executing timeout-bounded calls, a new worker is
+// only started if all existing workers are busy
+//
+// The pool is never destroyed and its workers are detached: at process exit a
+// worker may still be running a timed out call that can't be interrupted (e.g.
+// inside nauty), joining it would hang exit and destroying the pool under it
+// would be undefined behaviour. Such workers are simply terminated along with
+// the process.
+
+class WorkerPool
+{
+public:
+  using job = std::function<void()>;
+
+  static WorkerPool &instance();
+
+  void submit(job j);
+
+  unsigned num_workers() const;
+
+private:
+  WorkerPool() = default;
+
+  void work();
+
+  unsigned _num_workers = 0u;
+  std::deque<job> _jobs;
+  unsigned _idle = 0u;
+
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+};
+
+// timeout function wrappers
 
 template<typename FUNC>
 using ReturnType = decltype(std::declval<FUNC>()());
@@ -82,76 +199,47 @@ template<typename FUNC>
 using AbortableReturnType =
   decltype(std::declval<FUNC>()(std::declval<flag>()));
 
-template<typename FUNC>
-using ReturnTypeWrapper = boost::optional<ReturnType<FUNC>>;
-
 template<typename FUNC, typename REP, typename PERIOD>
 std::future<ReturnType<FUNC>> future_with_timeout(
   std::string const &what,
   std::chrono::duration<REP, PERIOD> const &timeout,
   FUNC &&f)
 {
-  std::packaged_task<ReturnType<FUNC>()> task(f);
+  auto task(std::make_shared<std::packaged_task<ReturnType<FUNC>()>>(
+    std::forward<FUNC>(f)));
 
-  auto future(task.get_future());
+  auto future(task->get_future());
 
   _inc_timeout_thread_count();
 
-  std::thread thread(std::move(task));
+  WorkerPool::instance().submit([task]{
+    (*task)();
 
-  if (future.wait_for(timeout) == std::future_status::timeout) {
-    thread.detach();
+    _dec_timeout_thread_count();
+  });
 
+  if (future.wait_for(timeout) == std::future_status::timeout)
     throw TimeoutError(what);
 
-  } else {
-    thread.join();
-
-    return future;
-  }
+  return future;
 }
 
-template<typename FUNC, typename REP, typename PERIOD>
-typename std::enable_if<std::is_void<ReturnType<FUNC>>::value>::type
-run_with_timeout(std::string const &what,
-                 std::chrono::duration<REP, PERIOD> const &timeout,
-                 FUNC &&f)
-{
-  (void)future_with_timeout(
-    what,
-    timeout,
-    [&]() {
-       try {
-         f();
-       } catch (AbortedError const &aborted) {}
-
-       _dec_timeout_thread_count();
-     });
-}
+// the worker may observe an expired deadline before the caller's wait for the
+// future runs out, an AbortedError raised in this way is reported as a timeout
 
 template<typename FUNC, typename REP, typename PERIOD>
-typename std::enable_if<!std::is_void<ReturnType<FUNC>>::value,
-                        ReturnType<FUNC>>::type
-run_with_timeout(std::string const &what,
-                 std::chrono::duration<REP, PERIOD> const &timeout,
-                 FUNC &&f)
+ReturnType<FUNC> run_with_timeout(
+  std::string const &what,
+  std::chrono::duration<REP, PERIOD> const &timeout,
+  FUNC &&f)
 {
-  auto future(future_with_timeout(
-    what,
-    timeout,
-    [&]() {
-      ReturnTypeWrapper<FUNC> ret;
+  auto future(future_with_timeout(what, timeout, std::forward<FUNC>(f)));
 
-      try {
-        ret = f();
-      } catch (AbortedError const &) {}
-
-       _dec_timeout_thread_count();
-
-       return ret;
-    }));
-
-  return *future.get();
+  try {
+    return future.get();
+  } catch (AbortedError const &) {
+    throw TimeoutError(what);
+  }
 }
 
 template<typename FUNC, typename REP, typename PERIOD>
@@ -160,15 +248,15 @@ run_abortable_with_timeout(std::string const &what,
                            std::chrono::duration<REP, PERIOD> const &timeout,
                            FUNC &&f)
 {
-  flag aborted(unset());
-
   if (timeout <= std::chrono::duration<double>::zero())
-    return f(aborted);
+    return f(unset());
+
+  flag aborted(unset(timeout));
 
   try {
     return run_with_timeout(what,
                             timeout,
-                            [&]{ return f(aborted); });
+                            [f, aborted]{ return f(aborted); });
 
   } catch (TimeoutError const &) {
     set(aborted);
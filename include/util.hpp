@@ -3,6 +3,7 @@
 
 #include "hash.hpp"
 #include "iterator.hpp"
+#include "memory.hpp"
 #include "numeric.hpp"
 #include "parse.hpp"
 #include "random.hpp"
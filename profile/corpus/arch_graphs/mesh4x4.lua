@@ -0,0 +1,10 @@
+local mpsym = require 'mpsym'
+
+local processors = mpsym.identical_processors(16, 'P')
+local channels = mpsym.grid_channels(processors, 'C')
+
+return mpsym.ArchGraph:create{
+  directed = false,
+  processors = processors,
+  channels = channels
+}
@@ -0,0 +1,17 @@
+local mpsym = require 'mpsym'
+
+return mpsym.ArchGraph:create{
+  directed = false,
+  processors = {
+    {0, 'P'},
+    {1, 'P'},
+    {2, 'P'},
+    {3, 'P'}
+  },
+  channels = {
+    {0, 1, 'C'},
+    {1, 2, 'C'},
+    {2, 3, 'C'},
+    {3, 0, 'C'}
+  }
+}
@@ -0,0 +1,691 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <getopt.h>
+#include <libgen.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "arch_graph_system.hpp"
+#include "bsgs.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+#include "task_mapping.hpp"
+#include "task_mapping_orbit.hpp"
+#include "util.hpp"
+
+#include "profile_args.hpp"
+#include "profile_parse.hpp"
+#include "profile_read.hpp"
+#include "profile_run.hpp"
+#include "profile_util.hpp"
+
+using namespace profile;
+
+using json = nlohmann::json;
+
+namespace
+{
+
+std::string progname;
+
+void usage(std::ostream &s)
+{
+  char const *opts[] = {
+    "[-h|--help]",
+    "-c|--corpus CORPUS_DIR",
+    "[--cases CASES]",
+    "[-b|--baseline BASELINE]",
+    "[-o|--output OUTPUT]",
+    "[--update-baseline]",
+    "[--allow-missing-baseline]",
+    "[-f|--filter REGEX]",
+    "[--time-tolerance TIME_TOLERANCE]",
+    "[--time-threshold TIME_THRESHOLD]",
+    "[--memory-tolerance MEMORY_TOLERANCE]",
+    "[-r|--num-runs NUM_RUNS]",
+    "[--num-discarded-runs NUM_DISCARDED_RUNS]",
+    "[-v|--verbose]"
+  };
+
+  s << "usage: " << progname << '\n';
+  for (char const *opt : opts)
+    s << "  " << opt << '\n';
+}
+
+struct ProfileOptions
+{
+  std::string corpus_dir;
+
+  // case list within 'corpus_dir', cases which can't be part of the default
+  // list (e.g. because they have no recorded timings yet) live in separate
+  // lists with their own baselines
+  std::string cases = "corpus.json";
+
+  std::string baseline;
+  std::string output;
+  bool update_baseline = false;
+  std::string filter = ".*";
+
+  // cases without baseline entry fail the check unless this is set, in which
+  // case they are only reported
+  bool allow_missing_baseline = false;
+
+  // relative slowdowns / memory increases above these fractions are reported
+  // as regressions, slowdowns are additionally only reported if they exceed
+  // 'time_threshold' seconds in absolute terms
+  double time_tolerance = 0.25;
+  double time_threshold = 0.01;
+  double memory_tolerance = 0.25;
+
+  unsigned num_runs = 5u;
+  unsigned num_discarded_runs = 1u;
+  bool verbose = false;
+};
+
+json read_json(std::string const &file)
+{
+  Stream stream;
+  stream.open(file.c_str());
+
+  return json::parse(read_file(stream.stream));
+}
+
+void write_json(std::string const &file, json const &j)
+{
+  std::ofstream stream(file);
+  if (!stream)
+    throw std::runtime_error("failed to open file: " + file);
+
+  stream << j.dump(2) << '\n';
+}
+
+GenericGroup read_group(json const &corpus,
+                        unsigned group_lineno,
+                        ProfileOptions const &options)
+{
+  Stream stream;
+  stream.open((options.corpus_dir + "/" + corpus["groups"].get<std::string>()).c_str());
+
+  std::string group_line;
+  foreach_line(stream.stream,
+               [&](std::string const &line, unsigned lineno){
+                 if (lineno == group_lineno)
+                   group_line = line;
+               });
+
+  if (group_line.empty())
+    throw std::invalid_argument("no such group: " + std::to_string(group_lineno));
+
+  return parse_group(group_line);
+}
+
+std::shared_ptr<mpsym::ArchGraphSystem> read_arch_graph_system(
+  json const &corpus,
+  json const &c,
+  ProfileOptions const &options)
+{
+  if (c.contains("group"))
+    return read_group(corpus, c["group"], options).to_arch_graph_system();
+
+  Stream stream;
+  stream.open((options.corpus_dir + "/" + c["arch_graph"].get<std::string>()).c_str());
+
+  return mpsym::ArchGraphSystem::from_lua(read_file(stream.stream));
+}
+
+mpsym::internal::BSGSOptions bsgs_options_mpsym(json const &c)
+{
+  using mpsym::internal::BSGSOptions;
+
+  BSGSOptions bsgs_options;
+
+  auto schreier_sims(c.value("schreier_sims", "deterministic"));
+
+  if (schreier_sims == "deterministic")
+    bsgs_options.construction = BSGSOptions::Construction::SCHREIER_SIMS;
+  else if (schreier_sims == "random")
+    bsgs_options.construction = BSGSOptions::Construction::SCHREIER_SIMS_RANDOM;
+  else
+    throw std::invalid_argument("invalid schreier sims variant: " + schreier_sims);
+
+  auto transversals(c.value("transversals", "explicit"));
+
+  if (transversals == "explicit")
+    bsgs_options.transversals = BSGSOptions::Transversals::EXPLICIT;
+  else if (transversals == "schreier-trees")
+    bsgs_options.transversals = BSGSOptions::Transversals::SCHREIER_TREES;
+  else
+    throw std::invalid_argument("invalid transversals: " + transversals);
+
+  return bsgs_options;
+}
+
+mpsym::ReprOptions repr_options_mpsym(json const &c)
+{
+  using mpsym::ReprOptions;
+
+  ReprOptions repr_options;
+
+  auto repr_method(c.value("repr_method", "iterate"));
+
+  if (repr_method == "iterate")
+    repr_options.method = ReprOptions::Method::ITERATE;
+  else if (repr_method == "orbits")
+    repr_options.method = ReprOptions::Method::ORBITS;
+  else if (repr_method == "local_search")
+    repr_options.method = ReprOptions::Method::LOCAL_SEARCH;
+  else
+    throw std::invalid_argument("invalid repr method: " + repr_method);
+
+  return repr_options;
+}
+
+// cases that finish too quickly to be timed reliably can be repeated within
+// every run
+template<typename FUNC>
+void repeat(json const &c, FUNC &&f)
+{
+  unsigned repetitions = c.value("repetitions", 1u);
+
+  for (unsigned i = 0u; i < repetitions; ++i)
+    f();
+}
+
+json run_schreier_sims(json const &corpus,
+                       json const &c,
+                       ProfileOptions const &options,
+                       std::vector<double> *ts)
+{
+  using mpsym::internal::BSGS;
+  using mpsym::internal::PermGroup;
+
+  auto group(read_group(corpus, c["group"], options));
+  auto generators(parse_generators_mpsym(group.degree, group.generators));
+  auto bsgs_options(bsgs_options_mpsym(c));
+
+  run_cpp([&]{
+            repeat(c, [&]{
+              PermGroup g(BSGS(group.degree, generators, &bsgs_options));
+            });
+          },
+          options.num_discarded_runs,
+          options.num_runs,
+          ts);
+
+  return json::object();
+}
+
+json run_automorphisms(json const &corpus,
+                       json const &c,
+                       ProfileOptions const &options,
+                       std::vector<double> *ts)
+{
+  auto ags(read_arch_graph_system(corpus, c, options));
+
+  run_cpp([&]{
+            repeat(c, [&]{
+              ags->reset_automorphisms();
+              ags->automorphisms();
+            });
+          },
+          options.num_discarded_runs,
+          options.num_runs,
+          ts);
+
+  return {{"order", ags->num_automorphisms().str()}};
+}
+
+json run_task_orbits(json const &corpus,
+                     json const &c,
+                     ProfileOptions const &options,
+                     std::vector<double> *ts)
+{
+  using mpsym::TMORs;
+
+  auto ags(read_arch_graph_system(corpus, c, options));
+
+  Stream stream;
+  stream.open((options.corpus_dir + "/" + c["task_mappings"].get<std::string>()).c_str());
+
+  auto task_mappings(parse_task_mappings_mpsym(
+    read_file(stream.stream, c.value("task_mappings_limit", 0u))));
+
+  auto repr_options(repr_options_mpsym(c));
+
+  ags->init_repr();
+
+  auto map_tasks = [&]{
+    TMORs task_orbits;
+    for (auto const &task_mapping : task_mappings)
+      ags->repr(task_mapping, task_orbits, &repr_options);
+
+    return task_orbits.num_orbits();
+  };
+
+  // untimed reference run, also doubles as warm up
+  auto num_orbits(map_tasks());
+
+  run_cpp([&]{ repeat(c, map_tasks); },
+          options.num_discarded_runs,
+          options.num_runs,
+          ts);
+
+  return {{"orbits", num_orbits}};
+}
+
+json run_case(json const &corpus, json const &c, ProfileOptions const &options)
+{
+  std::vector<double> ts;
+
+  json res;
+
+  auto kind(c["kind"].get<std::string>());
+
+  if (kind == "schreier_sims")
+    res = run_schreier_sims(corpus, c, options, &ts);
+  else if (kind == "automorphisms")
+    res = run_automorphisms(corpus, c, options, &ts);
+  else if (kind == "task_orbits")
+    res = run_task_orbits(corpus, c, options, &ts);
+  else
+    throw std::invalid_argument("invalid case kind: " + kind);
+
+  std::sort(ts.begin(), ts.end());
+
+  res["time"] = ts[ts.size() / 2u];
+  res["time_min"] = ts.front();
+  res["time_max"] = ts.back();
+
+  return res;
+}
+
+// runs every case in a separate child process so that the peak resident set
+// size can be attributed to it
+json run_case_isolated(json const &corpus,
+                       json const &c,
+                       ProfileOptions const &options)
+{
+  int fds[2];
+  if (pipe(fds) == -1)
+    throw std::runtime_error("failed to create pipe");
+
+  pid_t child;
+  switch ((child = fork())) {
+  case -1:
+    throw std::runtime_error("failed to fork child process");
+  case 0:
+    {
+      close(fds[0]);
+
+      json res;
+      try {
+        res = run_case(corpus, c, options);
+      } catch (std::exception const &e) {
+        res = {{"error", e.what()}};
+      }
+
+      auto res_str(res.dump());
+
+      for (std::size_t written = 0u; written < res_str.size();) {
+        auto n = write(fds[1], res_str.data() + written, res_str.size() - written);
+        if (n == -1) {
+          if (errno == EINTR)
+            continue;
+
+          _Exit(EXIT_FAILURE);
+        }
+
+        written += static_cast<std::size_t>(n);
+      }
+
+      close(fds[1]);
+
+      _Exit(EXIT_SUCCESS);
+    }
+  }
+
+  close(fds[1]);
+
+  std::string res_str;
+
+  char buf[4096];
+  for (;;) {
+    auto n = read(fds[0], buf, sizeof(buf));
+    if (n == -1 && errno == EINTR)
+      continue;
+
+    if (n <= 0)
+      break;
+
+    res_str.append(buf, static_cast<std::size_t>(n));
+  }
+
+  close(fds[0]);
+
+  int status;
+  struct rusage usage;
+  if (wait4(child, &status, 0, &usage) == -1)
+    throw std::runtime_error("failed to wait for child process");
+
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    throw std::runtime_error("the forked child process terminated prematurely");
+
+  auto res(json::parse(res_str));
+
+  if (res.contains("error"))
+    throw std::runtime_error(res["error"].get<std::string>());
+
+  res["max_rss_kb"] = usage.ru_maxrss;
+
+  return res;
+}
+
+// results must not change at all, not even when the baseline is updated
+std::vector<std::string> changed_results(json const &res, json const &base)
+{
+  std::vector<std::string> changed;
+
+  for (char const *key : {"orbits", "order"}) {
+    if (base.contains(key) && res.contains(key) && base[key] != res[key])
+      changed.push_back(std::string(key) + " changed");
+  }
+
+  return changed;
+}
+
+// returns true if 'res' regressed compared to 'base'
+bool compare(std::string const &name,
+             json const &res,
+             json const &base,
+             ProfileOptions const &options)
+{
+  std::vector<std::string> improvements;
+
+  auto regressions(changed_results(res, base));
+
+  // entries may only pin down results until timings are recorded by an
+  // actual run, until then timing regressions would slip through unnoticed
+  if (!base.contains("time")) {
+    if (!regressions.empty()) {
+      warning("REGRESSION", name + ":", mpsym::util::join(regressions, ", "));
+    } else {
+      error("UNTIMED", name + ": baseline entry without timings,",
+            "record them via --update-baseline");
+    }
+
+    return true;
+  }
+
+  double t = res["time"];
+  double t_base = base["time"];
+
+  if (t > t_base * (1.0 + options.time_tolerance) &&
+      t - t_base > options.time_threshold) {
+    regressions.push_back("time");
+  } else if (t < t_base * (1.0 - options.time_tolerance) &&
+             t_base - t > options.time_threshold) {
+    improvements.push_back("time");
+  }
+
+  if (base.contains("max_rss_kb")) {
+    double mem = res["max_rss_kb"];
+    double mem_base = base["max_rss_kb"];
+
+    if (mem > mem_base * (1.0 + options.memory_tolerance))
+      regressions.push_back("memory");
+    else if (mem < mem_base * (1.0 - options.memory_tolerance))
+      improvements.push_back("memory");
+  }
+
+  auto summary(name + ": " + std::to_string(t) + "s (baseline " +
+               std::to_string(t_base) + "s), " +
+               res["max_rss_kb"].dump() + "KiB (baseline " +
+               base.value("max_rss_kb", json()).dump() + "KiB)");
+
+  if (!regressions.empty()) {
+    warning("REGRESSION", summary, "=>", mpsym::util::join(regressions, ", "));
+    return true;
+  }
+
+  if (!improvements.empty())
+    info("IMPROVED", summary, "=>", mpsym::util::join(improvements, ", "));
+  else
+    info("OK", summary);
+
+  return false;
+}
+
+bool do_profile(ProfileOptions const &options)
+{
+  auto corpus(read_json(options.corpus_dir + "/" + options.cases));
+
+  json baseline;
+  if (!options.baseline.empty()) {
+    try {
+      baseline = read_json(options.baseline);
+    } catch (std::runtime_error const &) {
+      if (!options.update_baseline)
+        throw;
+    }
+  }
+
+  if (baseline.is_null())
+    baseline = {{"cases", json::object()}};
+
+  json results = {
+    {"num_runs", options.num_runs},
+    {"num_discarded_runs", options.num_discarded_runs},
+    {"cases", json::object()}
+  };
+
+  std::regex filter(options.filter);
+
+  unsigned num_regressions = 0u;
+  unsigned num_failures = 0u;
+  unsigned num_missing = 0u;
+
+  for (auto const &c : corpus["cases"]) {
+    auto name(c["name"].get<std::string>());
+
+    if (!std::regex_search(name, filter))
+      continue;
+
+    if (options.verbose)
+      debug("Running", name);
+
+    json res;
+    try {
+      res = run_case_isolated(corpus, c, options);
+    } catch (std::exception const &e) {
+      error("FAILED", name + ":", e.what());
+      ++num_failures;
+      continue;
+    }
+
+    results["cases"][name] = res;
+
+    if (options.update_baseline) {
+      // don't overwrite pinned down results with different ones
+      if (baseline["cases"].contains(name)) {
+        auto changed(changed_results(res, baseline["cases"][name]));
+
+        if (!changed.empty()) {
+          error("CHANGED", name + ":", mpsym::util::join(changed, ", "));
+          ++num_regressions;
+          continue;
+        }
+      }
+
+      baseline["cases"][name] = res;
+
+      info("Recorded", name);
+      continue;
+    }
+
+    if (!baseline["cases"].contains(name)) {
+      if (options.allow_missing_baseline)
+        warning("NEW", name + ": no baseline entry");
+      else
+        error("MISSING", name + ": no baseline entry");
+
+      ++num_missing;
+      continue;
+    }
+
+    if (compare(name, res, baseline["cases"][name], options))
+      ++num_regressions;
+  }
+
+  if (!options.output.empty())
+    write_json(options.output, results);
+
+  if (options.update_baseline) {
+    // entries of cases that were filtered out or failed are kept
+    write_json(options.baseline, baseline);
+
+    if (num_regressions > 0u)
+      error(num_regressions, "case(s) not recorded because their results changed");
+  } else if (num_regressions > 0u) {
+    error(num_regressions, "regression(s) detected");
+  } else {
+    info("No regressions detected");
+  }
+
+  if (num_failures > 0u)
+    error(num_failures, "case(s) failed");
+
+  // unchecked cases must not pass silently
+  bool missing_ok = options.update_baseline || options.baseline.empty() ||
+                    options.allow_missing_baseline;
+
+  if (num_missing > 0u) {
+    if (missing_ok) {
+      warning(num_missing, "case(s) not checked against a baseline");
+    } else {
+      error(num_missing, "case(s) without baseline entry,",
+            "record them via --update-baseline (or pass",
+            "--allow-missing-baseline)");
+    }
+  }
+
+  return num_regressions == 0u && num_failures == 0u &&
+         (num_missing == 0u || missing_ok);
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+  using mpsym::util::stof;
+  using mpsym::util::stox;
+
+  progname = basename(argv[0]);
+
+  struct option long_options[] = {
+    {"help",                   no_argument,       0,       'h'},
+    {"corpus",                 required_argument, 0,       'c'},
+    {"cases",                  required_argument, 0,        7 },
+    {"baseline",               required_argument, 0,       'b'},
+    {"output",                 required_argument, 0,       'o'},
+    {"update-baseline",        no_argument,       0,        1 },
+    {"allow-missing-baseline", no_argument,       0,        6 },
+    {"filter",                 required_argument, 0,       'f'},
+    {"time-tolerance",         required_argument, 0,        2 },
+    {"time-threshold",         required_argument, 0,        3 },
+    {"memory-tolerance",       required_argument, 0,        4 },
+    {"num-runs",               required_argument, 0,       'r'},
+    {"num-discarded-runs",     required_argument, 0,        5 },
+    {"verbose",                no_argument,       0,       'v'},
+    {nullptr,                  0,                 nullptr,  0 }
+  };
+
+  ProfileOptions options;
+
+  for (;;) {
+    int c = getopt_long(argc, argv, "hc:b:o:f:r:v", long_options, nullptr);
+    if (c == -1)
+      break;
+
+    try {
+      switch(c) {
+      case 'h':
+        usage(std::cout);
+        return EXIT_SUCCESS;
+      case 'c':
+        options.corpus_dir = optarg;
+        break;
+      case 7:
+        options.cases = optarg;
+        break;
+      case 'b':
+        options.baseline = optarg;
+        break;
+      case 'o':
+        options.output = optarg;
+        break;
+      case 1:
+        options.update_baseline = true;
+        break;
+      case 'f':
+        options.filter = optarg;
+        break;
+      case 2:
+        options.time_tolerance = stof<double>(optarg);
+        break;
+      case 3:
+        options.time_threshold = stof<double>(optarg);
+        break;
+      case 4:
+        options.memory_tolerance = stof<double>(optarg);
+        break;
+      case 'r':
+        options.num_runs = stox<unsigned>(optarg);
+        break;
+      case 5:
+        options.num_discarded_runs = stox<unsigned>(optarg);
+        break;
+      case 6:
+        options.allow_missing_baseline = true;
+        break;
+      case 'v':
+        options.verbose = true;
+        break;
+      default:
+        return EXIT_FAILURE;
+      }
+    } catch (std::invalid_argument const &e) {
+      error("invalid option argument:", e.what());
+      return EXIT_FAILURE;
+    }
+  }
+
+  CHECK_OPTION(!options.corpus_dir.empty(), "--corpus option is mandatory");
+
+  CHECK_OPTION(options.num_runs > 0u, "--num-runs must be positive");
+
+  CHECK_OPTION(!options.update_baseline || !options.baseline.empty(),
+               "--update-baseline requires --baseline");
+
+  try {
+    if (!do_profile(options))
+      return EXIT_FAILURE;
+  } catch (std::exception const &e) {
+    error("profiling failed:", e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
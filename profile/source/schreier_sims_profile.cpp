@@ -49,6 +49,7 @@ void usage(std::ostream &s)
     "                      dont_reduce_gens,",
     "                      dont_use_known_order",
     "                      dont_reduce_arch_graph}]",
+    "[--disjoint-decomposition {complete|incomplete}]",
     "[-g|--groups GROUPS]",
     "[-a|--arch-graph ARCH_GRAPH]",
     "[--arch-graph-args ARCH_GRAPH_ARGS]",
@@ -80,6 +81,8 @@ struct ProfileOptions
                                 "dont_use_known_order",
                                 "dont_reduce_arch_graph"};
 
+  VariantOption disjoint_decomposition{"complete", "incomplete"};
+
   std::vector<std::string> arch_graph_args;
 
   bool groups_input = false;
@@ -139,8 +142,9 @@ std::string make_perm_group_gap(gap::PermSet const &generators,
   return "StabChain(Group(" + generators.permutations + "));\n";
 }
 
-void make_perm_group_mpsym(mpsym::internal::PermSet const &generators,
-                           ProfileOptions const &options)
+mpsym::internal::PermGroup make_perm_group_mpsym(
+  mpsym::internal::PermSet const &generators,
+  ProfileOptions const &options)
 {
   using mpsym::internal::BSGS;
   using mpsym::internal::PermGroup;
@@ -149,6 +153,24 @@ void make_perm_group_mpsym(mpsym::internal::PermSet const &generators,
   auto bsgs_options(bsgs_options_mpsym(options));
 
   PermGroup g(BSGS(generators.degree(), generators, &bsgs_options));
+
+  if (options.disjoint_decomposition.is_set())
+    g.disjoint_decomposition(options.disjoint_decomposition.is("complete"));
+
+  return g;
+}
+
+void dump_memory_usage_mpsym(mpsym::internal::PermGroup const &group)
+{
+  debug("Memory usage:", group.memory_usage(), "bytes");
+
+  auto levels(group.bsgs().level_memory_usage());
+  for (auto i = 0u; i < levels.size(); ++i) {
+    debug("  Level", i,
+          "transversals:", levels[i].transversals,
+          "labels:", levels[i].labels,
+          "orbit:", levels[i].orbit);
+  }
 }
 
 template <typename T>
@@ -227,11 +249,16 @@ std::vector<double> run_groups(unsigned degree,
   } else if (options.implementation.is("mpsym")) {
     auto generators_mpsym(parse_generators_mpsym(degree, generators));
 
-    run_cpp([&]{ make_perm_group_mpsym(generators_mpsym, options); },
+    mpsym::internal::PermGroup group;
+
+    run_cpp([&]{ group = make_perm_group_mpsym(generators_mpsym, options); },
             options.num_discarded_runs,
             options.num_runs,
             &ts);
 
+    if (options.verbose)
+      dump_memory_usage_mpsym(group);
+
   } else if (options.implementation.is("permlib")) {
     auto generators_permlib(parse_generators_permlib(degree, generators));
 
@@ -279,15 +306,16 @@ std::vector<double> run_arch_graph(std::string const &arch_graph,
     automorphism_generators = parse_generators_mpsym(0, gap_output[1]);
 
   } else if (options.implementation.is("mpsym")) {
-    auto bsgs_options(bsgs_options_mpsym(options));
+    mpsym::AutomorphismOptions automorphism_options(
+      bsgs_options_mpsym(options));
 
     run_cpp([&]{
               if (options.bsgs_options.is_set("dont_reduce_arch_graph")) {
                 ag->reset_repr();
-                ag->init_repr(&bsgs_options);
+                ag->init_repr(&automorphism_options);
               } else {
                 ag->reset_automorphisms();
-                ag->automorphisms(&bsgs_options);
+                ag->automorphisms(&automorphism_options);
               }
             },
             options.num_discarded_runs,
@@ -299,6 +327,9 @@ std::vector<double> run_arch_graph(std::string const &arch_graph,
     if (!options.bsgs_options.is_set("dont_reduce_arch_graph"))
       automorphism_generators = ag->automorphisms().generators();
 
+    if (options.verbose)
+      debug("Memory usage:", ag->memory_usage(), "bytes");
+
   } else if (options.implementation.is("permlib")) {
     throw std::logic_error("graph automorphisms not supported by permlib");
   }
@@ -329,6 +360,11 @@ void run(FUNC &&f,
     debug_timer_dump("strip");
     debug_timer_dump("extend base");
     debug_timer_dump("update strong gens");
+
+    if (options.disjoint_decomposition.is("complete")) {
+      debug_timer_dump("disjoint decomp dependency classes");
+      debug_timer_dump("disjoint decomp complete");
+    }
   }
 }
 
@@ -395,6 +431,7 @@ int main(int argc, char **argv)
     {"verbose",             no_argument,       0,       'v'},
     {"compile-gap",         no_argument,       0,        5 },
     {"show-gap-errors",     no_argument,       0,        6 },
+    {"disjoint-decomposition", required_argument, 0,     7 },
     {nullptr,               0,                 nullptr,  0 }
   };
 
@@ -458,6 +495,9 @@ int main(int argc, char **argv)
       case 6:
         options.show_gap_errors = true;
         break;
+      case 7:
+        options.disjoint_decomposition.set(optarg);
+        break;
       default:
         return EXIT_FAILURE;
       }
@@ -476,6 +516,10 @@ int main(int argc, char **argv)
   CHECK_OPTION((options.implementation.is("gap") || options.transversals.is_set()),
                "--transversal-storage option is mandatory when not using gap");
 
+  CHECK_OPTION((!options.disjoint_decomposition.is_set() ||
+                (options.implementation.is("mpsym") && options.groups_input)),
+               "--disjoint-decomposition only supported for mpsym groups");
+
   CHECK_OPTION(options.groups_input != options.arch_graph_input,
                "EITHER --arch-graph OR --groups must be given");
 
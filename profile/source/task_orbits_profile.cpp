@@ -1,21 +1,29 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <nlohmann/json.hpp>
+
 #include <getopt.h>
 #include <libgen.h>
+#include <sys/resource.h>
 
 #include "arch_graph_automorphisms.hpp"
 #include "arch_graph_system.hpp"
 #include "dump.hpp"
 #include "task_mapping.hpp"
-#include "task_orbits.hpp"
+#include "task_mapping_orbit.hpp"
 #include "timer.hpp"
 
 #include "profile_args.hpp"
@@ -56,7 +64,11 @@ void usage(std::ostream &s)
     "[--check-accuracy-mpsym]",
     "[-v|--verbose]",
     "[--compile-gap]",
-    "[--show-gap-errors]"
+    "[--show-gap-errors]",
+    "[--threads NUM_THREADS[,NUM_THREADS...]]",
+    "[--batch-size BATCH_SIZE]",
+    "[--cache {warm|cold}]",
+    "[--json JSON_OUTPUT]"
   };
 
   s << "usage: " << progname << '\n';
@@ -91,6 +103,12 @@ struct ProfileOptions
   int verbosity = 0;
   bool compile_gap = false;
   bool show_gap_errors = false;
+
+  // throughput mode, enabled by passing one or more thread counts
+  std::vector<unsigned> threads;
+  unsigned batch_size = 64u;
+  VariantOption cache{"warm", "cold"};
+  std::string json_output;
 };
 
 std::string map_tasks_gap_local_search(ProfileOptions const &)
@@ -387,6 +405,10 @@ void map_tasks_mpsym_wrapper(std::shared_ptr<mpsym::ArchGraphSystem> ags,
     debug_progress_done();
 
     debug("=> Found", task_orbits->num_orbits(), "orbit representatives");
+
+    debug("Memory usage (automorphisms):", ags->memory_usage(), "bytes");
+    debug("Memory usage (representatives):", task_orbits->memory_usage(), "bytes");
+
     if (options.verbosity > 1) {
       for (auto const &repr : *task_orbits)
         debug(DUMP(repr));
@@ -451,6 +473,205 @@ void check_accuracy(mpsym::TMORs const &task_orbits_actual,
   info("=> Found", reprs_found.size(), "of", reprs_check.size(), "representatives");
 }
 
+struct ThroughputResult
+{
+  unsigned num_threads;
+  unsigned long long num_mapped;
+  double mappings_per_second;
+  double latency_p50;
+  double latency_p99;
+  long max_rss_kb;
+  unsigned num_orbits;
+};
+
+double percentile(std::vector<double> const &sorted, double p)
+{
+  if (sorted.empty())
+    return 0.0;
+
+  auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+
+  return sorted[std::max(rank, static_cast<std::size_t>(1u)) - 1u];
+}
+
+ThroughputResult map_tasks_mpsym_throughput(
+  std::shared_ptr<mpsym::ArchGraphSystem> ags,
+  mpsym::TaskMappingVector const &task_mappings,
+  mpsym::ReprOptions const &repr_options,
+  unsigned num_threads,
+  ProfileOptions const &options)
+{
+  using clock = std::chrono::steady_clock;
+
+  using mpsym::TMORs;
+
+  auto seconds = [](clock::duration d)
+  { return std::chrono::duration<double>(d).count(); };
+
+  ThroughputResult res;
+  res.num_threads = num_threads;
+  res.num_mapped = 0ULL;
+
+  std::vector<double> latencies;
+  double t_total = 0.0;
+
+  TMORs task_orbits;
+
+  if (options.cache.is("warm")) {
+    ags->prepare_repr();
+
+    TMORs task_orbits_warmup;
+    for (auto const &task_mapping : task_mappings)
+      ags->repr_prepared(task_mapping, task_orbits_warmup, &repr_options);
+  }
+
+  for (unsigned r = 0u; r < options.num_discarded_runs + options.num_runs; ++r) {
+    bool take_time = r >= options.num_discarded_runs;
+
+    if (options.cache.is("cold"))
+      ags->reset_repr();
+
+    std::vector<TMORs> thread_task_orbits(num_threads);
+    std::vector<std::vector<double>> thread_latencies(num_threads);
+
+    auto map_task = [&](unsigned i, unsigned t){
+      auto start(clock::now());
+
+      ags->repr_prepared(task_mappings[i], thread_task_orbits[t], &repr_options);
+
+      thread_latencies[t].push_back(seconds(clock::now() - start));
+    };
+
+    auto t_start(clock::now());
+
+    // all lazily computed state is determined on this thread, the workers
+    // below only read it
+    if (options.cache.is("cold"))
+      ags->prepare_repr();
+
+    std::atomic<unsigned> next(0u);
+
+    auto worker = [&](unsigned t){
+      for (;;) {
+        unsigned first = next.fetch_add(options.batch_size);
+        if (first >= task_mappings.size())
+          break;
+
+        unsigned last = std::min(first + options.batch_size,
+                                 static_cast<unsigned>(task_mappings.size()));
+
+        for (unsigned i = first; i < last; ++i)
+          map_task(i, t);
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1u; t < num_threads; ++t)
+      workers.emplace_back(worker, t);
+
+    worker(0u);
+
+    for (auto &w : workers)
+      w.join();
+
+    double t_run = seconds(clock::now() - t_start);
+
+    if (!take_time)
+      continue;
+
+    t_total += t_run;
+    res.num_mapped += task_mappings.size();
+
+    for (auto const &l : thread_latencies)
+      latencies.insert(latencies.end(), l.begin(), l.end());
+
+    task_orbits = TMORs();
+    for (auto const &o : thread_task_orbits)
+      task_orbits.insert_all(o.begin(), o.end());
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+
+  res.mappings_per_second = static_cast<double>(res.num_mapped) / t_total;
+  res.latency_p50 = percentile(latencies, 0.50);
+  res.latency_p99 = percentile(latencies, 0.99);
+
+  // peak over the whole process lifetime, i.e. over all thread counts so far
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  res.max_rss_kb = usage.ru_maxrss;
+
+  res.num_orbits = task_orbits.num_orbits();
+
+  return res;
+}
+
+void run_throughput(std::shared_ptr<mpsym::ArchGraphSystem> ags,
+                    mpsym::TaskMappingVector const &task_mappings,
+                    ProfileOptions const &options)
+{
+  using json = nlohmann::json;
+
+  if (task_mappings.empty())
+    throw std::invalid_argument("no task mappings given");
+
+  auto repr_options(map_tasks_mpsym_repr_options(options));
+
+  json results = json::array();
+
+  for (unsigned num_threads : options.threads) {
+    if (options.verbosity > 0)
+      debug("Mapping tasks using", num_threads, "thread(s)");
+
+    auto res(map_tasks_mpsym_throughput(
+      ags, task_mappings, repr_options, num_threads, options));
+
+    result("Threads:", res.num_threads);
+    result("Throughput:", res.mappings_per_second, "mappings/s");
+    result("Latency (p50):", res.latency_p50, "s");
+    result("Latency (p99):", res.latency_p99, "s");
+    result("Peak RSS:", res.max_rss_kb, "KiB");
+
+    if (options.verbosity > 0) {
+      debug("=> Found", res.num_orbits, "orbit representatives");
+      debug("Memory usage (automorphisms):", ags->memory_usage(), "bytes");
+    }
+
+    results.push_back({
+      {"threads", res.num_threads},
+      {"mappings", res.num_mapped},
+      {"mappings_per_second", res.mappings_per_second},
+      {"latency_p50", res.latency_p50},
+      {"latency_p99", res.latency_p99},
+      {"max_rss_kb", res.max_rss_kb},
+      {"orbits", res.num_orbits}
+    });
+  }
+
+  if (options.json_output.empty())
+    return;
+
+  json out = {
+    {"repr_method", options.repr_method.get()},
+    {"cache", options.cache.get()},
+    {"batch_size", options.batch_size},
+    {"num_runs", options.num_runs},
+    {"num_discarded_runs", options.num_discarded_runs},
+    {"results", results}
+  };
+
+  if (options.json_output == "-") {
+    std::cout << out.dump(2) << std::endl;
+    return;
+  }
+
+  std::ofstream stream(options.json_output);
+  if (!stream)
+    throw std::runtime_error("failed to open file: " + options.json_output);
+
+  stream << out.dump(2) << '\n';
+}
+
 void run(std::shared_ptr<mpsym::ArchGraphSystem> ags,
          std::shared_ptr<mpsym::ArchGraphSystem> ags_check,
          std::string const &task_mappings,
@@ -479,6 +700,10 @@ void run(std::shared_ptr<mpsym::ArchGraphSystem> ags,
   if (options.library.is("gap")) {
     run_gap(ags->to_gap(), options, nullptr, &ts);
 
+  } else if (options.library.is("mpsym") && !options.threads.empty()) {
+    run_throughput(ags, parse_task_mappings_mpsym(task_mappings), options);
+    return;
+
   } else if (options.library.is("mpsym")) {
     TMORs task_orbits, task_orbits_check;
 
@@ -590,6 +815,10 @@ int main(int argc, char **argv)
     {"verbose",                             no_argument,       0,       'v'},
     {"compile-gap",                         no_argument,       0,        11},
     {"show-gap-errors",                     no_argument,       0,        12},
+    {"threads",                             required_argument, 0,        13},
+    {"batch-size",                          required_argument, 0,        14},
+    {"cache",                               required_argument, 0,        15},
+    {"json",                                required_argument, 0,        16},
     {nullptr,                               0,                 nullptr,  0 }
   };
 
@@ -678,6 +907,20 @@ int main(int argc, char **argv)
       case 12:
         options.show_gap_errors = true;
         break;
+      case 13:
+        foreach_option(optarg,
+                       [&](std::string const &option)
+                       { options.threads.push_back(stox<unsigned>(option)); });
+        break;
+      case 14:
+        options.batch_size = stox<unsigned>(optarg);
+        break;
+      case 15:
+        options.cache.set(optarg);
+        break;
+      case 16:
+        options.json_output = optarg;
+        break;
       default:
         return EXIT_FAILURE;
       }
@@ -701,6 +944,24 @@ int main(int argc, char **argv)
                !(options.check_accuracy_gap || options.check_accuracy_mpsym),
                "--check-accuracy-* only available when using mpsym");
 
+  CHECK_OPTION(options.threads.empty() ||
+               (options.library.is("mpsym") &&
+                !(options.check_accuracy_gap || options.check_accuracy_mpsym)),
+               "--threads only available when using mpsym without accuracy checks");
+
+  CHECK_OPTION(std::find(options.threads.begin(), options.threads.end(), 0u) ==
+               options.threads.end(),
+               "--threads must be positive");
+
+  CHECK_OPTION(options.batch_size > 0u, "--batch-size must be positive");
+
+  CHECK_OPTION((!options.cache.is_set() && options.json_output.empty()) ||
+               !options.threads.empty(),
+               "--cache and --json only available in combination with --threads");
+
+  if (!options.cache.is_set())
+    options.cache.set("warm");
+
   try {
     do_profile(automorphisms_stream, task_mappings_stream, options);
   } catch (std::exception const &e) {
@@ -6,6 +6,11 @@ from math import factorial
 from random import sample
 from textwrap import dedent
 
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
 import mpsym as mp
 
 
@@ -101,6 +106,29 @@ class PermGroupTest(unittest.TestCase):
         self.assertEqual(set(self.pg), self.pg_elems)
         self.assertEqual(set(self.pg_id), self.pg_id_elems)
 
+    @unittest.skipIf(np is None, "numpy not available")
+    def test_chunks(self):
+        chunks = list(self.pg.chunks(chunk_size=5))
+        self.assertEqual([len(chunk) for chunk in chunks], [5, 5, 2])
+
+        elems = {mp.Perm(tuple(row)) for chunk in chunks for row in chunk.tolist()}
+        self.assertEqual(elems, self.pg_elems)
+
+        out = np.empty((5, 4), dtype=np.uint32)
+
+        elems = set()
+        for chunk in self.pg.chunks(out=out):
+            self.assertTrue(np.shares_memory(chunk, out))
+            elems.update(mp.Perm(tuple(row)) for row in chunk.tolist())
+
+        self.assertEqual(elems, self.pg_elems)
+
+        with self.assertRaises(ValueError):
+            self.pg.chunks(out=np.empty((5, 4), dtype=np.int64))
+
+        with self.assertRaises(ValueError):
+            self.pg.chunks(out=np.empty((5, 3), dtype=np.uint32))
+
     def test_contains(self):
         for elem in permutations(self.dom):
           elem = mp.Perm(elem)
@@ -110,6 +138,12 @@ class PermGroupTest(unittest.TestCase):
           else:
             self.assertFalse(elem in self.pg)
 
+    def test_contains_elements(self):
+        elems = [mp.Perm(elem) for elem in permutations(self.dom)]
+
+        self.assertEqual(self.pg.contains_elements(elems),
+                         [elem in self.pg_elems for elem in elems])
+
     def test_bool(self):
         self.assertTrue(self.pg)
         self.assertFalse(self.pg_id)
@@ -124,6 +158,13 @@ class PermGroupTest(unittest.TestCase):
     def test_properties(self):
         self.assertFalse(self.pg.is_symmetric())
 
+    def test_memory_usage(self):
+        levels = self.pg.memory_usage(levels=True)
+
+        self.assertEqual(len(levels), len(self.pg.bsgs()[0]))
+        self.assertGreater(self.pg.memory_usage(),
+                           sum(sum(level.values()) for level in levels))
+
 
 class ArchGraphSystemTest(unittest.TestCase):
     HAEC_LUA = dedent(
@@ -203,6 +244,51 @@ class ArchGraphSystemTest(unittest.TestCase):
                 for method in 'iterate', 'orbit':
                     self.assertEqual(self.ag.representative(mapping, method=method), orbit[0])
 
+    @unittest.skipIf(np is None, "numpy not available")
+    def test_orbit_chunks(self):
+        for orbit in [self.ag_orbit1, self.ag_orbit2]:
+            chunks = list(self.ag.orbit(orbit[0]).chunks(chunk_size=3))
+            self.assertTrue(all(chunk.shape[1] == 4 for chunk in chunks))
+
+            mappings = [tuple(row) for chunk in chunks for row in chunk.tolist()]
+            self.assertCountEqual(mappings, orbit)
+
+            out = np.empty((len(orbit), 4), dtype=np.uint32)
+            chunks = list(self.ag.orbit(orbit[0]).chunks(out=out))
+            self.assertEqual(len(chunks), 1)
+            self.assertCountEqual([tuple(row) for row in out.tolist()], orbit)
+
+    @unittest.skipIf(np is None, "numpy not available")
+    def test_representatives(self):
+        mappings = np.array(self.ag_orbit1 + self.ag_orbit2, dtype=np.uint32)
+
+        expected = np.array([self.ag_orbit1[0]] * len(self.ag_orbit1) +
+                            [self.ag_orbit2[0]] * len(self.ag_orbit2))
+
+        for num_threads in 1, 4:
+            representatives = self.ag.representatives(mappings, num_threads=num_threads)
+
+            self.assertEqual(representatives.shape, mappings.shape)
+            self.assertTrue((representatives == expected).all())
+
+        with self.assertRaises(ValueError):
+            self.ag.representatives(np.zeros(4, dtype=np.uint32))
+
+        with self.assertRaises(ValueError):
+            self.ag.representatives(np.full((1, 4), 64, dtype=np.uint32))
+
+    @unittest.skipIf(np is None, "numpy not available")
+    def test_orbit_indices(self):
+        mappings = np.array(self.ag_orbit1 + self.ag_orbit2 + self.ag_orbit1[:1])
+
+        orbits = mp.Representatives()
+        orbit_indices = self.ag.orbit_indices(mappings, orbits, num_threads=2)
+
+        expected = [0] * len(self.ag_orbit1) + [1] * len(self.ag_orbit2) + [0]
+
+        self.assertEqual(orbit_indices.tolist(), expected)
+        self.assertEqual(len(orbits), 2)
+
     def test_orbit(self):
         for orbit in [self.ag_orbit1, self.ag_orbit2]:
             self.assertCountEqual(list(self.ag.orbit(orbit[0])), orbit)
@@ -216,6 +302,23 @@ class ArchGraphSystemTest(unittest.TestCase):
 
           self.assertEqual(orbit_len(ag.orbit(range(n))), factorial(n))
 
+    def test_progress(self):
+        ag = mp.ArchGraphAutomorphisms(mp.PermGroup.symmetric(5))
+
+        states = []
+        orbit = list(ag.orbit(range(5), progress=states.append))
+
+        self.assertTrue(states[-1]['finished'])
+        self.assertEqual(states[-1]['phase'], 'orbit_enumeration')
+        self.assertEqual(states[-1]['elements'], len(orbit))
+
+        states = []
+        ag = mp.ArchGraphAutomorphisms(mp.PermGroup.dihedral(10))
+        ag.representative([4, 3, 2], method='iterate', progress=states.append)
+
+        self.assertTrue(states[-1]['finished'])
+        self.assertEqual(states[-1]['phase'], 'repr_iterate')
+
     def test_from_nauty(self):
         vertices_super = 4
         adj_super = {0: [1], 1: [2], 2: [3]}
@@ -238,6 +341,16 @@ class ArchGraphSystemTest(unittest.TestCase):
         ag_from_json = mp.ArchGraphSystem.from_json(json)
         self.assertEqual(ag_from_json.automorphisms(), self.ag.automorphisms())
 
+    def test_topologies(self):
+        for ag, num_automorphisms in [(mp.ArchGraph.mesh([3, 3]), 8),
+                                      (mp.ArchGraph.torus([3, 4]), 48),
+                                      (mp.ArchGraph.hypercube(3), 48),
+                                      (mp.ArchGraph.fat_tree(2, 2), 8)]:
+            self.assertEqual(ag.num_automorphisms(), num_automorphisms)
+
+            ag_from_json = mp.ArchGraphSystem.from_json(ag.to_json())
+            self.assertEqual(ag_from_json.automorphisms(), ag.automorphisms())
+
     def test_expand_automorphisms(self):
         ag_expanded = self.ag.expand_automorphisms()
         self.assertEqual(ag_expanded.automorphisms(), self.ag.automorphisms())
@@ -250,6 +363,21 @@ class ArchGraphSystemTest(unittest.TestCase):
         ag_pickle = pickle.loads(pickle.dumps(self.ag))
         self.assertEqual(ag_pickle.automorphisms(), self.ag.automorphisms())
 
+        self.ag.initialize()
+
+        ag_pickle = pickle.loads(pickle.dumps(self.ag))
+        for orbit in [self.ag_orbit1, self.ag_orbit2]:
+            for mapping in orbit:
+                self.assertEqual(ag_pickle.representative(mapping), orbit[0])
+
+    def test_memory_usage(self):
+        self.ag.automorphisms()
+        self.assertGreater(self.ag.memory_usage(), 0)
+
+        orbits = mp.Representatives()
+        self.ag.representative(self.ag_orbit1[0], representatives=orbits)
+        self.assertGreater(orbits.memory_usage(), 0)
+
 
 class ArchGraphSystemBugFixTest(unittest.TestCase):
     def test_duplicate_channels(self):
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <memory>
@@ -17,6 +18,7 @@
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include <nlohmann/json.hpp>
+#include <pybind11/numpy.h>
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/pytypes.h>
@@ -27,11 +29,14 @@
 #include "arch_graph_cluster.hpp"
 #include "arch_graph_system.hpp"
 #include "arch_uniform_super_graph.hpp"
+#include "csr_graph.hpp"
+#include "instrument.hpp"
 #include "nauty_graph.hpp"
 #include "parse.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
+#include "progress.hpp"
 #include "task_mapping.hpp"
 #include "task_mapping_orbit.hpp"
 #include "timeout.hpp"
@@ -56,6 +61,7 @@ using mpsym::TMORs;
 
 using mpsym::internal::ArchGraphAutomorphisms;
 using mpsym::internal::BSGS;
+using mpsym::internal::CSRGraph;
 using mpsym::internal::NautyGraph;
 using mpsym::internal::Perm;
 using mpsym::internal::PermGroup;
@@ -65,9 +71,16 @@ using mpsym::util::IteratorAdaptor;
 using mpsym::util::parse_perm;
 using mpsym::util::stream;
 
+using mpsym::internal::progress::phase_name;
+using mpsym::internal::progress::State;
+
+using mpsym::internal::timeout::AbortableReturnType;
+using mpsym::internal::timeout::AbortedError;
 using mpsym::internal::timeout::flag;
+using mpsym::internal::timeout::Poll;
 using mpsym::internal::timeout::run_abortable_with_timeout;
 using mpsym::internal::timeout::TimeoutError;
+using mpsym::internal::timeout::unset;
 
 namespace
 {
@@ -75,6 +88,10 @@ namespace
 template<typename T = unsigned>
 using Sequence = std::vector<T>;
 
+// read without copying if already C contiguous and of matching dtype
+template<typename T = unsigned>
+using Array = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
 template<typename T>
 using contained_type =
   typename std::remove_reference<decltype(*std::declval<T>().begin())>::type;
@@ -112,10 +129,35 @@ template<typename T>
 py::tuple to_tuple(T const &obj)
 { return sequence_to_tuple(to_sequence(obj)); }
 
-ReprOptions str_to_repr_options(std::string const &method)
+// progress callbacks may be invoked by threads not holding the GIL (e.g. those
+// of representatives()), the progress state is passed on as a dict
+mpsym::internal::progress::Callback to_progress_callback(
+  py::object const &callback)
+{
+  if (callback.is_none())
+    return nullptr;
+
+  auto f(std::make_shared<py::object>(callback));
+
+  return [f](State const &state)
+  {
+    py::gil_scoped_acquire acquire;
+
+    (*f)(py::dict("phase"_a = phase_name(state.phase),
+                  "elements"_a = state.elements,
+                  "processed"_a = state.processed,
+                  "remaining"_a = state.remaining,
+                  "finished"_a = state.finished));
+  };
+}
+
+ReprOptions str_to_repr_options(std::string const &method,
+                                py::object const &progress = py::none())
 {
   ReprOptions options;
 
+  options.progress_callback = to_progress_callback(progress);
+
   if (method == "auto") {
     options.method = ReprOptions::Method::AUTO;
   } else if (method == "iterate") {
@@ -155,19 +197,244 @@ T arch_graph_json_cast(ArchGraphSystem const &self, std::string const &key)
   return ret;
 }
 
+// the call may keep running on a worker thread after a timeout (e.g. inside
+// nauty), so it holds on to self and copies of all arguments instead of
+// referring to objects owned by the caller
 template<typename FUNC, typename ...ARGS>
 typename std::result_of<FUNC(ArchGraphSystem *, ARGS..., flag)>::type
 arch_graph_timeout(std::string const &what,
                    double timeout,
-                   ArchGraphSystem &self,
+                   std::shared_ptr<ArchGraphSystem> const &self,
                    FUNC f,
-                   ARGS &&...args)
+                   ARGS const &...args)
 {
+  auto call(std::bind(f, self, args..., std::placeholders::_1));
+
   return run_abortable_with_timeout(
     what,
     std::chrono::duration<double>(timeout),
-    [&](flag aborted)
-    { return (self.*f)(std::forward<ARGS>(args)..., aborted); });
+    [call](flag aborted)
+    { return call(aborted); });
+}
+
+// representatives are determined on the calling thread since the abortable
+// code involved honors the deadline on its own, only initialization (which
+// may call into nauty) is run on a worker thread
+template<typename FUNC>
+AbortableReturnType<FUNC>
+arch_graph_repr_timeout(std::string const &what,
+                        double timeout,
+                        std::shared_ptr<ArchGraphSystem> const &self,
+                        FUNC f)
+{
+  if (timeout <= 0.0)
+    return f(unset());
+
+  auto aborted(unset(std::chrono::duration<double>(timeout)));
+
+  if (!self->repr_ready())
+    arch_graph_timeout(what, timeout, self, &ArchGraphSystem::init_repr, nullptr);
+
+  try {
+    return f(aborted);
+  } catch (AbortedError const &) {
+    throw TimeoutError(what);
+  }
+}
+
+// snapshots retain automorphisms and representative state so that unpickled
+// objects don't have to recompute them
+py::bytes arch_graph_pickle(ArchGraphSystem const &self)
+{ return py::bytes(self.to_snapshot()); }
+
+template<typename T>
+std::shared_ptr<T> arch_graph_unpickle(py::object const &state)
+{
+  std::shared_ptr<ArchGraphSystem> ags;
+
+  // objects pickled by earlier versions are stored as JSON strings
+  if (py::isinstance<py::bytes>(state))
+    ags = ArchGraphSystem::from_snapshot(state.cast<std::string>());
+  else
+    ags = ArchGraphSystem::from_json(state.cast<std::string>());
+
+  auto res(std::dynamic_pointer_cast<T>(ags));
+  if (!res)
+    throw std::runtime_error("pickled object has wrong type");
+
+  return res;
+}
+
+// iterates over a sequence in chunks of rows of a two-dimensional array which
+// are filled while the GIL is released, either newly allocated or views of a
+// preallocated array that is overwritten by every chunk
+template<typename IT>
+class ChunkIterator
+{
+public:
+  using fill_row_type =
+    std::function<void(typename IT::value_type const &, unsigned *)>;
+
+  ChunkIterator(IT first,
+                IT last,
+                unsigned row_size,
+                fill_row_type fill_row,
+                py::ssize_t chunk_size,
+                py::object out)
+  : _it(first),
+    _last(last),
+    _row_size(row_size),
+    _fill_row(fill_row),
+    _chunk_size(chunk_size),
+    _out(out)
+  {
+    if (_out.is_none()) {
+      if (_chunk_size <= 0)
+        throw std::invalid_argument("chunk size must be positive");
+
+      return;
+    }
+
+    if (!py::isinstance<Array<>>(_out))
+      throw std::invalid_argument("output array must be C contiguous and of type uint32");
+
+    auto out_array(_out.cast<py::array>());
+
+    if (!out_array.writeable())
+      throw std::invalid_argument("output array must be writeable");
+
+    if (out_array.ndim() != 2 ||
+        out_array.shape(0) == 0 ||
+        out_array.shape(1) != static_cast<py::ssize_t>(_row_size)) {
+      throw std::invalid_argument("output array has wrong shape");
+    }
+
+    _chunk_size = out_array.shape(0);
+  }
+
+  py::object next()
+  {
+    if (_it == _last)
+      throw py::stop_iteration();
+
+    Array<> chunk(_out.is_none() ? Array<>({_chunk_size,
+                                            static_cast<py::ssize_t>(_row_size)})
+                                 : _out.cast<Array<>>());
+
+    unsigned *data = chunk.mutable_data();
+
+    py::ssize_t num_rows = 0;
+
+    {
+      py::gil_scoped_release release;
+
+      while (num_rows < _chunk_size && _it != _last) {
+        _fill_row(*_it, data + num_rows * _row_size);
+
+        ++_it;
+        ++num_rows;
+      }
+    }
+
+    if (num_rows == _chunk_size)
+      return std::move(chunk);
+
+    return chunk[py::slice(0, num_rows, 1)];
+  }
+
+private:
+  IT _it;
+  IT _last;
+  unsigned _row_size;
+  fill_row_type _fill_row;
+  py::ssize_t _chunk_size;
+  py::object _out;
+};
+
+template<typename IT>
+void add_chunk_iterator(py::module &m, char const *name)
+{
+  py::class_<ChunkIterator<IT>>(m, name)
+    .def("__iter__",
+         [](ChunkIterator<IT> &self) -> ChunkIterator<IT> &
+         { return self; })
+    .def("__next__", &ChunkIterator<IT>::next);
+}
+
+constexpr py::ssize_t CHUNK_SIZE_DEFAULT = 1 << 16;
+
+std::pair<unsigned, unsigned> mapping_array_shape(Array<> const &mappings)
+{
+  if (mappings.ndim() != 2)
+    throw std::invalid_argument("mappings must be a two-dimensional array");
+
+  return {static_cast<unsigned>(mappings.shape(0)),
+          static_cast<unsigned>(mappings.shape(1))};
+}
+
+// runs with the GIL released as part of the timeout bounded computation, the
+// automorphisms' degree is only queried once
+void check_mapping_array(ArchGraphSystem const &self,
+                         unsigned const *tasks,
+                         std::size_t size,
+                         flag aborted)
+{
+  unsigned degree = self.automorphisms_degree();
+
+  Poll poll(aborted, 1u << 12);
+
+  for (std::size_t i = 0u; i < size; ++i) {
+    if (tasks[i] >= degree)
+      throw std::invalid_argument("task index out of range");
+
+    poll("check_mapping_array");
+  }
+}
+
+Array<> arch_graph_repr_batch(std::shared_ptr<ArchGraphSystem> const &self,
+                              Array<> const &mappings,
+                              std::string const &method,
+                              unsigned num_threads,
+                              double timeout,
+                              py::object const &progress)
+{
+  unsigned num_mappings, num_tasks;
+  std::tie(num_mappings, num_tasks) = mapping_array_shape(mappings);
+
+  auto options(str_to_repr_options(method, progress));
+
+  Array<> representatives({mappings.shape(0), mappings.shape(1)});
+
+  unsigned const *mappings_data = mappings.data();
+  unsigned *representatives_data = representatives.mutable_data();
+
+  {
+    py::gil_scoped_release release;
+
+    // runs (and joins its threads) on the calling thread, so the buffers are
+    // never accessed after this returns, even on timeout
+    arch_graph_repr_timeout(
+      "representatives",
+      timeout,
+      self,
+      [&](flag aborted)
+      {
+        check_mapping_array(*self,
+                            mappings_data,
+                            static_cast<std::size_t>(num_mappings) * num_tasks,
+                            aborted);
+
+        self->repr_batch(mappings_data,
+                         representatives_data,
+                         num_mappings,
+                         num_tasks,
+                         &options,
+                         num_threads,
+                         aborted);
+      });
+  }
+
+  return representatives;
 }
 
 } // anonymous namespace
@@ -256,9 +523,18 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
                   if (vertices_reduced == 0)
                     vertices_reduced = vertices;
 
-                  NautyGraph g{vertices, directed};
+                  CSRGraph graph(vertices, [&](CSRGraph::Arcs &arc){
+                    for (auto const &p : adjacencies) {
+                      for (int to : p.second) {
+                        arc(p.first, to);
+
+                        if (!directed)
+                          arc(to, p.first);
+                      }
+                    }
+                  });
 
-                  g.add_edges(adjacencies);
+                  NautyGraph g(std::move(graph), directed);
 
                   if (!coloring.empty()) {
                     std::vector<std::vector<int>> coloring_;
@@ -311,7 +587,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
     .def("num_processors", &ArchGraphSystem::num_processors)
     .def("num_channels", &ArchGraphSystem::num_channels)
     .def("initialize",
-         [&](ArchGraphSystem &self, double timeout)
+         [](std::shared_ptr<ArchGraphSystem> const &self, double timeout)
          {
            arch_graph_timeout("initialize",
                               timeout,
@@ -321,7 +597,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
          },
          "timeout"_a = 0.0)
     .def("num_automorphisms",
-         [](ArchGraphSystem &self, double timeout)
+         [](std::shared_ptr<ArchGraphSystem> const &self, double timeout)
          {
            return arch_graph_timeout("num_automorphisms",
                                      timeout,
@@ -331,7 +607,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
          },
          "timeout"_a = 0.0)
     .def("automorphisms_generators",
-         [](ArchGraphSystem &self, double timeout)
+         [](std::shared_ptr<ArchGraphSystem> const &self, double timeout)
          {
            auto generators(arch_graph_timeout(
              "automorphisms_generators",
@@ -344,7 +620,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
          },
          "timeout"_a = 0.0)
     .def("automorphisms",
-         [](ArchGraphSystem &self, double timeout)
+         [](std::shared_ptr<ArchGraphSystem> const &self, double timeout)
          {
            return arch_graph_timeout("automorphisms",
                                      timeout,
@@ -354,108 +630,144 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
          },
          "timeout"_a = 0.0)
     .def("expand_automorphisms", &ArchGraphSystem::expand_automorphisms)
+    .def("memory_usage", &ArchGraphSystem::memory_usage)
     .def("orbit",
-         [&](ArchGraphSystem &self,
-             Sequence<> const &mapping,
-             double timeout)
+         [](std::shared_ptr<ArchGraphSystem> const &self,
+            Sequence<> const &mapping,
+            double timeout,
+            py::object const &progress)
          {
            for (unsigned task : mapping) {
-             if (task >= self.automorphisms_degree())
+             if (task >= self->automorphisms_degree())
                throw std::invalid_argument("task index out of range");
            }
 
-           return arch_graph_timeout("orbit",
-                                     timeout,
-                                     self,
-                                     &ArchGraphSystem::automorphisms_orbit,
-                                     mapping,
-                                     nullptr);
+           // only determining automorphisms is bounded by the timeout, the
+           // orbit is enumerated lazily afterwards
+           arch_graph_timeout("orbit",
+                              timeout,
+                              self,
+                              &ArchGraphSystem::automorphisms,
+                              nullptr);
+
+           auto orbit(self->automorphisms_orbit(mapping));
+
+           if (!progress.is_none())
+             orbit.set_progress_callback(to_progress_callback(progress));
+
+           return orbit;
          },
-         "mapping"_a, "timeout"_a = 0.0)
+         "mapping"_a, "timeout"_a = 0.0, "progress"_a = py::none())
     .def("representative",
-         [&](ArchGraphSystem &self,
-             Sequence<> const &mapping,
-             std::string const &method,
-             double timeout)
+         [](std::shared_ptr<ArchGraphSystem> const &self,
+            Sequence<> const &mapping,
+            std::string const &method,
+            double timeout,
+            py::object const &progress)
          {
-           using T = TaskMapping(ArchGraphSystem::*)(TaskMapping const &,
-                                                     ReprOptions const *,
-                                                     flag);
+           auto options(str_to_repr_options(method, progress));
 
-           auto options(str_to_repr_options(method));
-
-           auto repr(arch_graph_timeout("representative",
-                                        timeout,
-                                        self,
-                                        (T)&ArchGraphSystem::repr,
-                                        mapping,
-                                        &options));
+           auto repr(arch_graph_repr_timeout(
+             "representative",
+             timeout,
+             self,
+             [&](flag aborted)
+             { return self->repr(mapping, &options, aborted); }));
 
            return to_tuple(repr);
          },
-         "mapping"_a, "method"_a = "auto", "timeout"_a = 0.0)
+         "mapping"_a, "method"_a = "auto", "timeout"_a = 0.0,
+         "progress"_a = py::none())
     .def("representative",
-         [&](ArchGraphSystem &self,
-             Sequence<> const &mapping,
-             TMORs &representatives,
-             std::string const &method,
-             double timeout)
+         [](std::shared_ptr<ArchGraphSystem> const &self,
+            Sequence<> const &mapping,
+            TMORs &representatives,
+            std::string const &method,
+            double timeout,
+            py::object const &progress)
          {
-           using T = std::tuple<TaskMapping, bool, unsigned>
-                     (ArchGraphSystem::*)(TaskMapping const &,
-                                          TMORs &,
-                                          ReprOptions const *,
-                                          flag);
-
-
-           auto options(str_to_repr_options(method));
+           auto options(str_to_repr_options(method, progress));
 
            TaskMapping repr;
            bool orbit_new;
            unsigned orbit_index;
 
-           std::tie(repr, orbit_new, orbit_index) =
-             arch_graph_timeout("representative",
-                                timeout,
-                                self,
-                                (T)&ArchGraphSystem::repr,
-                                mapping,
-                                representatives,
-                                &options);
+           std::tie(repr, orbit_new, orbit_index) = arch_graph_repr_timeout(
+             "representative",
+             timeout,
+             self,
+             [&](flag aborted)
+             { return self->repr(mapping, representatives, &options, aborted); });
 
            return std::make_tuple(to_tuple(repr),
                                   orbit_new,
                                   orbit_index);
          },
-         "mapping"_a, "representatives"_a, "method"_a = "auto", "timeout"_a = 0.0);
+         "mapping"_a, "representatives"_a, "method"_a = "auto", "timeout"_a = 0.0,
+         "progress"_a = py::none())
+    .def("representatives",
+         &arch_graph_repr_batch,
+         "mappings"_a, "method"_a = "auto", "num_threads"_a = 1u, "timeout"_a = 0.0,
+         "progress"_a = py::none())
+    .def("orbit_indices",
+         [](std::shared_ptr<ArchGraphSystem> const &self,
+            Array<> const &mappings,
+            TMORs &representatives,
+            std::string const &method,
+            unsigned num_threads,
+            double timeout,
+            py::object const &progress)
+         {
+           auto reprs(arch_graph_repr_batch(self,
+                                            mappings,
+                                            method,
+                                            num_threads,
+                                            timeout,
+                                            progress));
+
+           auto num_mappings = reprs.shape(0);
+           auto num_tasks = reprs.shape(1);
+
+           Array<> orbit_indices(num_mappings);
+
+           unsigned const *reprs_data = reprs.data();
+           unsigned *orbit_indices_data = orbit_indices.mutable_data();
+
+           // representatives is owned by Python, so the GIL is kept here
+           for (py::ssize_t i = 0; i < num_mappings; ++i) {
+             unsigned const *repr = reprs_data + i * num_tasks;
+
+             TaskMapping mapping(std::vector<unsigned>(repr, repr + num_tasks));
+
+             orbit_indices_data[i] = representatives.insert(mapping).second;
+           }
+
+           return orbit_indices;
+         },
+         "mappings"_a, "representatives"_a, "method"_a = "auto", "num_threads"_a = 1u, "timeout"_a = 0.0,
+         "progress"_a = py::none());
 
   // ArchGraphAutomorphisms
   py::class_<ArchGraphAutomorphisms,
              ArchGraphSystem,
              std::shared_ptr<ArchGraphAutomorphisms>>(m, "ArchGraphAutomorphisms")
     .def(py::init<PermGroup>(), "automorphisms"_a)
-    .def(py::pickle(
-        [](ArchGraphAutomorphisms &self)
-        { return self.to_json(); },
-        [](std::string const &json)
-        {
-          return std::dynamic_pointer_cast<ArchGraphAutomorphisms>(
-            ArchGraphSystem::from_json(json));
-        }));
+    .def(py::pickle(&arch_graph_pickle, &arch_graph_unpickle<ArchGraphAutomorphisms>));
 
   // ArchGraph
   py::class_<ArchGraph,
              ArchGraphSystem,
              std::shared_ptr<ArchGraph>>(m, "ArchGraph")
     .def(py::init<bool>(), "directed"_a = true)
-    .def(py::pickle(
-        [](ArchGraph &self)
-        { return self.to_json(); },
-        [](std::string const &json)
-        {
-          return std::dynamic_pointer_cast<ArchGraph>(
-            ArchGraphSystem::from_json(json));
-        }))
+    .def(py::pickle(&arch_graph_pickle, &arch_graph_unpickle<ArchGraph>))
+    .def_static("mesh", &ArchGraph::mesh,
+                "dims"_a, "pl"_a = "P", "cl"_a = "C")
+    .def_static("torus", &ArchGraph::torus,
+                "dims"_a, "pl"_a = "P", "cl"_a = "C")
+    .def_static("hypercube", &ArchGraph::hypercube,
+                "dim"_a, "pl"_a = "P", "cl"_a = "C")
+    .def_static("fat_tree", &ArchGraph::fat_tree,
+                "arity"_a, "levels"_a, "pl"_a = "P", "sl"_a = "S", "cl"_a = "C")
     .def("directed", &ArchGraph::directed)
     .def("add_processor",
          (unsigned(ArchGraph::*)(std::string const &))
@@ -555,14 +867,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
              ArchGraphSystem,
              std::shared_ptr<ArchGraphCluster>>(m, "ArchGraphCluster")
     .def(py::init<>())
-    .def(py::pickle(
-        [](ArchGraphCluster &self)
-        { return self.to_json(); },
-        [](std::string const &json)
-        {
-          return std::dynamic_pointer_cast<ArchGraphCluster>(
-            ArchGraphSystem::from_json(json));
-        }))
+    .def(py::pickle(&arch_graph_pickle, &arch_graph_unpickle<ArchGraphCluster>))
     .def("add_subsystem", &ArchGraphCluster::add_subsystem, "subsystem"_a)
     .def("num_subsystems", &ArchGraphCluster::num_subsystems);
 
@@ -573,14 +878,11 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
     .def(py::init<std::shared_ptr<ArchGraphSystem>,
                   std::shared_ptr<ArchGraphSystem>>(),
          "super_graph"_a, "proto"_a)
-    .def(py::pickle(
-        [](ArchUniformSuperGraph &self)
-        { return self.to_json(); },
-        [](std::string const &json)
-        {
-          return std::dynamic_pointer_cast<ArchUniformSuperGraph>(
-            ArchGraphSystem::from_json(json));
-        }));
+    .def(py::pickle(&arch_graph_pickle, &arch_graph_unpickle<ArchUniformSuperGraph>));
+
+  // chunk iterators
+  add_chunk_iterator<TMO::const_iterator>(m, "OrbitChunkIterator");
+  add_chunk_iterator<PermGroup::const_iterator>(m, "PermGroupChunkIterator");
 
   // TMO
   py::class_<TMO>(m, "Orbit")
@@ -591,7 +893,25 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
 
            return py::make_iterator<py::return_value_policy::copy>(adaptor.begin(),
                                                                    adaptor.end());
-         }, py::keep_alive<0, 1>());
+         }, py::keep_alive<0, 1>())
+    .def("chunks",
+         [](TMO const &orbit, py::ssize_t chunk_size, py::object out)
+         {
+           auto first(orbit.begin());
+           unsigned num_tasks = static_cast<unsigned>((*first).size());
+
+           return ChunkIterator<TMO::const_iterator>(
+             first,
+             orbit.end(),
+             num_tasks,
+             [](TaskMapping const &mapping, unsigned *row)
+             { std::copy(mapping.begin(), mapping.end(), row); },
+             chunk_size,
+             out);
+         },
+         "chunk_size"_a = CHUNK_SIZE_DEFAULT, "out"_a = py::none(),
+         py::keep_alive<0, 1>())
+    .def("memory_usage", &TMO::memory_usage);
 
   // TMORs
   py::class_<TMORs>(m, "Representatives")
@@ -606,7 +926,8 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
     .def("__contains__",
          [](TMORs const &orbits, Sequence<> const &mapping)
          { return orbits.is_repr(mapping); },
-         "mapping"_a);
+         "mapping"_a)
+    .def("memory_usage", &TMORs::memory_usage);
 
   // Perm
   py::class_<Perm>(m, "Perm")
@@ -768,6 +1089,25 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
          [](PermGroup const &self)
          { return py::make_iterator<py::return_value_policy::copy>(self.begin(), self.end()); },
          py::keep_alive<0, 1>())
+    .def("chunks",
+         [](PermGroup const &self, py::ssize_t chunk_size, py::object out)
+         {
+           unsigned degree = self.degree();
+
+           return ChunkIterator<PermGroup::const_iterator>(
+             self.begin(),
+             self.end(),
+             degree,
+             [degree](Perm const &perm, unsigned *row)
+             {
+               for (unsigned i = 0u; i < degree; ++i)
+                 row[i] = perm[i];
+             },
+             chunk_size,
+             out);
+         },
+         "chunk_size"_a = CHUNK_SIZE_DEFAULT, "out"_a = py::none(),
+         py::keep_alive<0, 1>())
     .def("__contains__",
          [](PermGroup const &self, Perm const &p)
          {
@@ -781,6 +1121,18 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
          [](PermGroup const &self, std::string const &p)
          { return self.contains_element(str_to_perm(self.degree(), p)); },
          "perm"_a)
+    .def("contains_elements",
+         [](PermGroup const &self, Sequence<Perm> const &perms, unsigned num_threads)
+         {
+           for (auto const &p : perms) {
+             if (p.degree() != self.degree())
+               throw std::invalid_argument("mismatched degrees");
+           }
+
+           return self.contains_elements(PermSet(perms.begin(), perms.end()),
+                                         num_threads);
+         },
+         "perms"_a, "num_threads"_a = 0u)
     .def("__bool__",
          [](PermGroup const &self)
          { return !self.is_trivial(); })
@@ -809,7 +1161,45 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
          },
          "sorted"_a = true)
     .def("is_symmetric", &PermGroup::is_symmetric)
-    .def("is_transitive", &PermGroup::is_transitive);
+    .def("is_transitive", &PermGroup::is_transitive)
+    .def("memory_usage",
+         [&](PermGroup const &self, bool levels) -> py::object
+         {
+           if (!levels)
+             return py::cast(self.memory_usage());
+
+           py::list res;
+           for (auto const &level : self.bsgs().level_memory_usage()) {
+             res.append(py::dict("transversals"_a = level.transversals,
+                                 "labels"_a = level.labels,
+                                 "orbit"_a = level.orbit));
+           }
+
+           return res;
+         },
+         "levels"_a = false);
 
   py::implicitly_convertible<Sequence<Perm>, PermGroup>();
+
+  // instrumentation
+  m.def("instrumentation_enable",
+        [](bool enable)
+        { mpsym::internal::instrument::enable(enable); },
+        "enable"_a = true)
+   .def("instrumentation_reset", &mpsym::internal::instrument::reset)
+   .def("instrumentation_dump",
+        [](std::string const &format)
+        {
+          if (format == "json")
+            return mpsym::internal::instrument::dump_json();
+
+          if (format == "text") {
+            std::stringstream ss;
+            mpsym::internal::instrument::dump_text(ss);
+            return ss.str();
+          }
+
+          throw std::invalid_argument("invalid 'format'");
+        },
+        "format"_a = "json");
 }
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -18,6 +19,7 @@
 #include "perm_group.hpp"
 #include "perm_set.hpp"
 #include "string.hpp"
+#include "util.hpp"
 
 using json = nlohmann::json;
 
@@ -104,6 +106,7 @@ ArchGraph::ChannelType ArchGraph::new_channel_type(std::string const &cl)
 unsigned ArchGraph::add_processor(ProcessorType pt)
 {
   reset_automorphisms();
+  _automorphisms_preset.reset();
 
   _processor_type_instances[pt]++;
 
@@ -124,6 +127,7 @@ void ArchGraph::add_channel(unsigned from, unsigned to, ChannelType ct)
     return;
 
   reset_automorphisms();
+  _automorphisms_preset.reset();
 
   _channel_type_instances[ct]++;
 
@@ -202,6 +206,33 @@ unsigned ArchGraph::num_processors() const
 unsigned ArchGraph::num_channels() const
 { return static_cast<unsigned>(boost::num_edges(_adj)); }
 
+std::size_t ArchGraph::memory_usage_() const
+{
+  auto string_memory_usage = [](std::string const &str)
+  { return str.capacity(); };
+
+  // vertices hold a property and an out edge vector, out edges hold a target
+  // and a pointer to a separately allocated property
+  std::size_t adj = num_processors() * (sizeof(VertexProperty)
+                                        + 3u * sizeof(void *)) +
+                    num_channels() * (sizeof(EdgeProperty)
+                                      + 2u * sizeof(void *));
+
+  std::size_t preset = 0u;
+  if (_automorphisms_preset) {
+    preset = util::container_memory_usage(_automorphisms_preset->base) +
+             _automorphisms_preset->strong_generators.memory_usage();
+  }
+
+  return memory_usage_automorphisms() +
+         adj +
+         preset +
+         util::container_memory_usage(_processor_types, string_memory_usage) +
+         util::container_memory_usage(_channel_types, string_memory_usage) +
+         util::container_memory_usage(_processor_type_instances) +
+         util::container_memory_usage(_channel_type_instances);
+}
+
 ArchGraph::ChannelType ArchGraph::assert_channel_type(std::string const &cl)
 {
   ChannelType ct = 0u;
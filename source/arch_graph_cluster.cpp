@@ -80,11 +80,12 @@ ArchGraphCluster::automorphisms_(AutomorphismOptions const *options,
 
   std::vector<PermGroup> automorphisms(_subsystems.size());
   for (auto i = 0u; i < _subsystems.size(); ++i)
-    automorphisms[i] = _subsystems[i]->automorphisms(options);
+    automorphisms[i] = _subsystems[i]->automorphisms(options, aborted);
 
   return PermGroup::direct_product(automorphisms.begin(),
                                    automorphisms.end(),
-                                   options);
+                                   options,
+                                   aborted);
 }
 
 TaskMapping
@@ -108,4 +109,25 @@ ArchGraphCluster::repr_(TaskMapping const &mapping_,
   return mapping;
 }
 
+TaskMapping
+ArchGraphCluster::repr_prepared_(TaskMapping const &mapping_,
+                                 ReprOptions const *options_,
+                                 TMORs *,
+                                 timeout::flag aborted) const
+{
+  auto options(ReprOptions::fill_defaults(options_));
+
+  assert(_subsystems.size() > 0u);
+
+  TaskMapping mapping(mapping_);
+
+  for (auto i = 0u; i < _subsystems.size(); ++i) {
+    mapping = _subsystems[i]->repr_prepared(mapping, &options, aborted);
+
+    options.offset += _subsystems[i]->num_processors();
+  }
+
+  return mapping;
+}
+
 } // namespace mpsym
@@ -1,4 +1,8 @@
+#include <cassert>
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/graph/adjacency_list.hpp>
@@ -9,24 +13,102 @@ extern "C" {
 }
 
 #include "arch_graph.hpp"
+#include "bsgs.hpp"
+#include "csr_graph.hpp"
 #include "nauty_graph.hpp"
+#include "perm.hpp"
 #include "perm_group.hpp"
+#include "perm_group_cache.hpp"
+#include "perm_set.hpp"
+
+namespace
+{
+
+using mpsym::internal::BSGS;
+using mpsym::internal::BSGSOptions;
+using mpsym::internal::Perm;
+using mpsym::internal::PermSet;
+
+BSGS relabel(BSGS const &bsgs, Perm const &sigma, BSGSOptions const *options)
+{
+  auto sigma_inv(~sigma);
+
+  BSGS::Base base;
+  for (unsigned bp : bsgs.base())
+    base.push_back(sigma[bp]);
+
+  PermSet strong_generators;
+  for (Perm const &sg : bsgs.strong_generators())
+    strong_generators.insert(sigma_inv * sg * sigma);
+
+  return BSGS(bsgs.degree(), base, strong_generators, options);
+}
+
+int num_layers(int channel_types)
+{
+  int cts_log2 = 0; while (channel_types >>= 1) ++cts_log2;
+
+  return cts_log2 + 1;
+}
+
+} // anonymous namespace
 
 namespace mpsym
 {
 
 using namespace internal;
 
+ArchGraph::NautyEncoding ArchGraph::nauty_encoding() const
+{
+  if (_nauty_encoding != NautyEncoding::AUTO)
+    return _nauty_encoding;
+
+  // compare the number of vertices plus arcs of both encodings, this only
+  // depends on isomorphism invariants so isomorphic graphs are always encoded
+  // alike (which the group cache relies on)
+  std::size_t cts = num_channel_types();
+  std::size_t layers = num_layers(static_cast<int>(cts));
+
+  std::size_t size_layered = num_processors() * layers * layers;
+  std::size_t size_subdivided = num_processors();
+
+  for (auto ch : channels()) {
+    std::size_t bits = 0u;
+    for (auto ct = channel_type(ch) + 1u; ct; ct >>= 1)
+      bits += ct & 1u;
+
+    bool loop = source(ch) == target(ch);
+
+    if (directed()) {
+      size_layered += bits;
+      size_subdivided += 3u;
+    } else {
+      size_layered += 2u * bits;
+      size_subdivided += loop ? 3u : 5u;
+    }
+  }
+
+  return size_subdivided < size_layered ? NautyEncoding::SUBDIVIDED
+                                        : NautyEncoding::LAYERED;
+}
+
 NautyGraph ArchGraph::graph_nauty() const
 {
-  int cts = num_channel_types();
-  int cts_log2 = 0; while (cts >>= 1) ++cts_log2;
+  switch (nauty_encoding()) {
+    case NautyEncoding::SUBDIVIDED:
+      return graph_nauty_subdivided();
+    default:
+      return graph_nauty_layered();
+  }
+}
+
+NautyGraph ArchGraph::graph_nauty_layered() const
+{
+  int cts_log2 = num_layers(num_channel_types()) - 1;
 
   int n_orig = num_processors();
   int n = n_orig * (cts_log2 + 1u);
 
-  NautyGraph g(n, n_orig, directed());
-
   /* node numbering:
    *  ...     ...           ...
    *   |       |             |
@@ -36,20 +118,31 @@ NautyGraph ArchGraph::graph_nauty() const
    */
 
   // add edges
-  for (int level = 0; level <= cts_log2; ++level) {
-    for (int level_ = 0; level_ <= cts_log2; ++level_) {
-      if (level_ == level)
-        continue;
+  CSRGraph graph(n, [&](CSRGraph::Arcs &arc){
+    for (int level = 0; level <= cts_log2; ++level) {
+      for (int level_ = 0; level_ <= cts_log2; ++level_) {
+        if (level_ == level)
+          continue;
 
-      for (int v = 0; v < n_orig; ++v)
-        g.add_edge(v + level * n_orig, v + level_ * n_orig);
-    }
+        for (int v = 0; v < n_orig; ++v)
+          arc(v + level * n_orig, v + level_ * n_orig);
+      }
 
-    for (auto ch : channels()) {
-      if (channel_type(ch) + 1 & (1 << level))
-        g.add_edge(source(ch) + level * n_orig, target(ch) + level * n_orig);
+      for (auto ch : channels()) {
+        if (channel_type(ch) + 1 & (1 << level)) {
+          int from = static_cast<int>(source(ch)) + level * n_orig;
+          int to = static_cast<int>(target(ch)) + level * n_orig;
+
+          arc(from, to);
+
+          if (!directed())
+            arc(to, from);
+        }
+      }
     }
-  }
+  });
+
+  NautyGraph g(std::move(graph), directed(), n_orig);
 
   // set partition
   std::vector<std::vector<int>> ptn(num_processor_types() * (cts_log2 + 1));
@@ -67,6 +160,59 @@ NautyGraph ArchGraph::graph_nauty() const
   return g;
 }
 
+NautyGraph ArchGraph::graph_nauty_subdivided() const
+{
+  int n_orig = num_processors();
+  int n = n_orig + static_cast<int>(num_channels());
+
+  /* every channel (pe1, pe2) is replaced by a vertex ch and arcs (pe1, ch)
+   * and (ch, pe2) (plus their reverses if the graph is undirected, self
+   * channels then only result in a single edge), channel vertices follow the
+   * processors and are colored by channel type
+   */
+
+  // add edges
+  CSRGraph graph(n, [&](CSRGraph::Arcs &arc){
+    int v = n_orig;
+
+    for (auto ch : channels()) {
+      int from = static_cast<int>(source(ch));
+      int to = static_cast<int>(target(ch));
+
+      arc(from, v);
+
+      if (directed()) {
+        arc(v, to);
+      } else {
+        arc(v, from);
+
+        if (to != from) {
+          arc(v, to);
+          arc(to, v);
+        }
+      }
+
+      ++v;
+    }
+  });
+
+  NautyGraph g(std::move(graph), directed(), n_orig);
+
+  // set partition
+  std::vector<std::vector<int>> ptn(num_processor_types() + num_channel_types());
+
+  for (int v = 0; v < n_orig; ++v)
+    ptn[processor_type(v)].push_back(v);
+
+  int v = n_orig;
+  for (auto ch : channels())
+    ptn[num_processor_types() + channel_type(ch)].push_back(v++);
+
+  g.set_partition(ptn);
+
+  return g;
+}
+
 std::string ArchGraph::to_gap_nauty() const
 {
   auto g(graph_nauty());
@@ -84,9 +230,101 @@ PermSet ArchGraph::automorphism_generators_nauty()
 PermGroup ArchGraph::automorphisms_nauty(AutomorphismOptions const *options,
                                          timeout::flag aborted)
 {
-  auto generators(automorphism_generators_nauty());
+  bool use_group_cache = options && options->use_group_cache;
+  bool use_disk_cache = options && !options->group_cache_dir.empty();
+
+  if (!use_group_cache && !use_disk_cache) {
+    auto generators(automorphism_generators_nauty());
+
+    // nauty itself can't be interrupted, bail out before schreier sims
+    timeout::check(aborted, "automorphisms_nauty");
+
+    return PermGroup(BSGS(num_processors(), generators, options, aborted));
+  }
+
+  std::unique_ptr<PermGroupDiskCache> disk_cache;
+  if (use_disk_cache)
+    disk_cache.reset(new PermGroupDiskCache(options->group_cache_dir));
+
+  auto disk_cache_store = [&](std::string const &key, BSGS const &bsgs){
+    std::string error;
+    if (!disk_cache->store(key, bsgs, &error) &&
+        options->group_cache_error_callback) {
+      options->group_cache_error_callback(error);
+    }
+  };
+
+  // identical descriptions require neither nauty nor schreier sims
+  auto key_description("description;" + to_json());
+
+  if (disk_cache) {
+    auto bsgs_description(disk_cache->load(key_description, options));
+    if (bsgs_description)
+      return PermGroup(*bsgs_description);
+  }
+
+  // isomorphic graphs share a certificate, their automorphism groups are
+  // stored relative to the canonical labeling
+  std::string certificate;
+  std::vector<int> canonical_labeling;
+
+  auto generators(graph_nauty().automorphism_generators(&certificate,
+                                                        &canonical_labeling));
+
+  timeout::check(aborted, "automorphisms_nauty");
+
+  // processors occupy the first cells of the partition and thus the first
+  // positions of the canonical labeling
+  std::vector<unsigned> to_canonical(num_processors());
+  for (unsigned i = 0u; i < num_processors(); ++i) {
+    assert(static_cast<unsigned>(canonical_labeling[i]) < num_processors());
+    to_canonical[canonical_labeling[i]] = i;
+  }
+
+  Perm sigma(to_canonical);
+
+  auto key_certificate("certificate;" + certificate);
+
+  // transversal storage is part of the key since cached groups are shared
+  auto key_group_cache(std::to_string(static_cast<int>(options->transversals))
+                       + ";" + key_certificate);
+
+  std::shared_ptr<PermGroup const> canonical;
+
+  if (use_group_cache)
+    canonical = PermGroupCache::global().find(key_group_cache);
+
+  if (!canonical && disk_cache) {
+    auto bsgs_certificate(disk_cache->load(key_certificate, options));
+    if (bsgs_certificate)
+      canonical = std::make_shared<PermGroup const>(*bsgs_certificate);
+  }
+
+  if (canonical) {
+    if (use_group_cache)
+      PermGroupCache::global().insert(key_group_cache, *canonical);
+
+    auto bsgs(relabel(canonical->bsgs(), ~sigma, options));
+
+    if (disk_cache)
+      disk_cache_store(key_description, bsgs);
+
+    return PermGroup(bsgs);
+  }
+
+  BSGS bsgs(num_processors(), generators, options, aborted);
+
+  auto bsgs_canonical(relabel(bsgs, sigma, options));
+
+  if (use_group_cache)
+    PermGroupCache::global().insert(key_group_cache, PermGroup(bsgs_canonical));
+
+  if (disk_cache) {
+    disk_cache_store(key_description, bsgs);
+    disk_cache_store(key_certificate, bsgs_canonical);
+  }
 
-  return PermGroup(BSGS(num_processors(), generators, options, aborted));
+  return PermGroup(bsgs);
 }
 
 } // namespace mpsym
@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <exception>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -9,6 +11,8 @@
 #include <queue>
 #include <random>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -20,9 +24,12 @@
 #include "arch_graph_system.hpp"
 #include "arch_uniform_super_graph.hpp"
 #include "bsgs.hpp"
+#include "instrument.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
+#include "perm_group_cache.hpp"
 #include "perm_set.hpp"
+#include "progress.hpp"
 #include "task_mapping.hpp"
 #include "task_mapping_orbit.hpp"
 #include "timeout.hpp"
@@ -35,6 +42,26 @@ namespace mpsym
 
 using namespace internal;
 
+PermGroup ArchGraphSystem::automorphisms_cached(
+  AutomorphismOptions const *options,
+  timeout::flag aborted)
+{
+  if (!options || !options->use_group_cache)
+    return automorphisms_(options, aborted);
+
+  // transversal storage is part of the key since cached groups are shared
+  auto key(std::to_string(static_cast<int>(options->transversals)) + ";" +
+           to_json());
+
+  auto &cache(PermGroupCache::global());
+
+  auto cached(cache.find(key));
+  if (!cached)
+    cached = cache.insert(key, automorphisms_(options, aborted));
+
+  return *cached;
+}
+
 std::shared_ptr<ArchGraphSystem> ArchGraphSystem::expand_automorphisms() const
 {
   auto const *ag(dynamic_cast<ArchGraph const *>(this));
@@ -73,29 +100,178 @@ std::shared_ptr<ArchGraphSystem> ArchGraphSystem::expand_automorphisms() const
 TMO ArchGraphSystem::automorphisms_orbit(
   TaskMapping const &mapping,
   AutomorphismOptions const *options,
-  timeout::flag aborted)
+  timeout::flag aborted,
+  timeout::flag enumeration_aborted)
 {
   automorphisms(options, aborted);
 
-  return TMO(mapping, _automorphism_generators.with_inverses());
+  TMO orbit(mapping,
+            _automorphism_generators.with_inverses(),
+            enumeration_aborted);
+
+  if (options && options->progress_callback)
+    orbit.set_progress_callback(options->progress_callback,
+                                options->progress_interval);
+
+  return orbit;
 }
 
-bool ArchGraphSystem::automorphisms_symmetric(ReprOptions const *options)
+void ArchGraphSystem::repr_batch(unsigned const *mappings,
+                                 unsigned *representatives,
+                                 unsigned num_mappings,
+                                 unsigned num_tasks,
+                                 ReprOptions const *options,
+                                 unsigned num_threads,
+                                 timeout::flag aborted)
 {
-  TaskMapping representative;
+  if (num_mappings == 0u)
+    return;
+
+  // all lazily initialized state is determined on this thread, the worker
+  // threads below only read it
+  prepare_repr();
 
-  if (options->optimize_symmetric && !_automorphisms_is_symmetric_valid) {
-    _automorphisms_is_symmetric = _automorphisms.is_symmetric();
+  auto repr_rows = [&](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; ++i) {
+      unsigned const *row = mappings + static_cast<std::size_t>(i) * num_tasks;
 
-    if (_automorphisms_is_symmetric) {
-      _automorphisms_smp = _automorphism_generators.smallest_moved_point();
-      _automorphisms_lmp = _automorphism_generators.largest_moved_point();
+      TaskMapping mapping(std::vector<unsigned>(row, row + num_tasks));
+
+      auto representative(repr_prepared(mapping, options, aborted));
+
+      std::copy(representative.begin(),
+                representative.end(),
+                representatives + static_cast<std::size_t>(i) * num_tasks);
     }
+  };
+
+  if (num_threads == 0u)
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  num_threads = std::min(num_threads, num_mappings);
+
+  if (num_threads <= 1u) {
+    repr_rows(0u, num_mappings);
+    return;
+  }
+
+  unsigned chunk = (num_mappings + num_threads - 1u) / num_threads;
+
+  std::vector<std::thread> threads;
+  std::vector<std::exception_ptr> errors(num_threads);
+
+  for (unsigned t = 0u; t < num_threads; ++t) {
+    unsigned first = t * chunk;
+    unsigned last = std::min(first + chunk, num_mappings);
+
+    if (first >= last)
+      break;
+
+    threads.emplace_back([&, t, first, last]{
+      try {
+        repr_rows(first, last);
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
 
-    _automorphisms_is_symmetric_valid = true;
+  for (auto const &error : errors) {
+    if (error)
+      std::rethrow_exception(error);
   }
+}
+
+void ArchGraphSystem::init_automorphisms_symmetric()
+{
+  if (_automorphisms_is_symmetric_valid)
+    return;
+
+  _automorphisms_is_symmetric = _automorphisms.is_symmetric();
+
+  if (_automorphisms_is_symmetric) {
+    _automorphisms_smp = _automorphism_generators.smallest_moved_point();
+    _automorphisms_lmp = _automorphism_generators.largest_moved_point();
+  }
+
+  _automorphisms_is_symmetric_valid = true;
+}
+
+void ArchGraphSystem::prepare_repr_(AutomorphismOptions const *options,
+                                    timeout::flag aborted)
+{
+  automorphisms(options, aborted);
+
+  init_automorphisms_symmetric();
+
+  // the factors have already been initialized without decomposition
+  for (auto const &factor : _repr_decomposition)
+    factor->prepare_repr(nullptr, aborted);
+}
+
+void ArchGraphSystem::init_repr_decomposition(
+  AutomorphismOptions const *options_,
+  timeout::flag aborted)
+{
+  auto options(AutomorphismOptions::fill_defaults(options_));
+
+  if (!options.decompose_repr)
+    return;
+
+  _repr_decomposition.clear();
+
+  auto automs(automorphisms(&options, aborted));
+
+  if (automs.is_trivial() || automs.is_symmetric())
+    return;
+
+  // representatives are determined factor by factor, just like for an
+  // ArchGraphCluster, the factors act on all processors and are never
+  // decomposed any further
+  options.decompose_repr = false;
+
+  std::vector<std::shared_ptr<ArchGraphSystem>> decomposition;
+
+  for (PermGroup const &factor : automs.disjoint_decomposition(true,
+                                                               false,
+                                                               &options,
+                                                               aborted))
+    decomposition.push_back(std::make_shared<ArchGraphAutomorphisms>(factor));
 
-  return options->optimize_symmetric && _automorphisms_is_symmetric;
+  if (decomposition.size() < 2u)
+    return;
+
+  for (auto const &factor : decomposition)
+    factor->init_repr(&options, aborted);
+
+  _repr_decomposition = decomposition;
+}
+
+std::size_t ArchGraphSystem::memory_usage_automorphisms(
+  PermGroup const *shared_with) const
+{
+  return (shared_with ? _automorphisms.memory_usage(*shared_with)
+                      : _automorphisms.memory_usage()) +
+         _automorphism_generators.memory_usage() +
+         util::container_memory_usage(
+           _repr_decomposition,
+           [](std::shared_ptr<ArchGraphSystem> const &factor)
+           { return factor->memory_usage(); });
+}
+
+TaskMapping ArchGraphSystem::repr_decomposed(TaskMapping const &mapping,
+                                             ReprOptions const *options,
+                                             timeout::flag aborted) const
+{
+  TaskMapping representative(mapping);
+
+  for (auto const &factor : _repr_decomposition)
+    representative = factor->repr_prepared(representative, options, aborted);
+
+  return representative;
 }
 
 TaskMapping ArchGraphSystem::repr_(TaskMapping const &mapping,
@@ -103,13 +279,45 @@ TaskMapping ArchGraphSystem::repr_(TaskMapping const &mapping,
                                    TMORs *orbits,
                                    timeout::flag aborted)
 {
-  automorphisms();
+  auto options(ReprOptions::fill_defaults(options_));
+
+  // unlike prepare_repr, only initialize what 'options' actually require
+  automorphisms(nullptr, aborted);
+
+  if (!_automorphisms.is_trivial()) {
+    if (!_repr_decomposition.empty()) {
+      TaskMapping representative(mapping);
+
+      for (auto const &factor : _repr_decomposition)
+        representative = factor->repr(representative, &options, aborted);
+
+      return representative;
+    }
+
+    if (options.optimize_symmetric)
+      init_automorphisms_symmetric();
+  }
+
+  return ArchGraphSystem::repr_prepared_(mapping, &options, orbits, aborted);
+}
+
+TaskMapping ArchGraphSystem::repr_prepared_(TaskMapping const &mapping,
+                                            ReprOptions const *options_,
+                                            TMORs *orbits,
+                                            timeout::flag aborted) const
+{
+  INSTRUMENT_SCOPE(REPR);
+
+  assert(automorphisms_ready());
 
   auto options(ReprOptions::fill_defaults(options_));
 
   if (_automorphisms.is_trivial())
     return mapping;
 
+  if (!_repr_decomposition.empty())
+    return repr_decomposed(mapping, &options, aborted);
+
   if (automorphisms_symmetric(&options))
     return min_elem_symmetric(mapping, &options);
 
@@ -119,8 +327,8 @@ TaskMapping ArchGraphSystem::repr_(TaskMapping const &mapping,
            min_elem_orbits(mapping, &options, orbits, aborted) :
          options.method == ReprOptions::Method::LOCAL_SEARCH ?
            options.variant == ReprOptions::Variant::LOCAL_SEARCH_SA_LINEAR ?
-             min_elem_local_search_sa(mapping, &options) :
-             min_elem_local_search(mapping, &options) :
+             min_elem_local_search_sa(mapping, &options, aborted) :
+             min_elem_local_search(mapping, &options, aborted) :
          throw std::logic_error("unreachable");
 }
 
@@ -131,9 +339,26 @@ TaskMapping ArchGraphSystem::min_elem_iterate(TaskMapping const &tasks,
 {
   TaskMapping representative(tasks);
 
+  timeout::Poll poll(aborted);
+
+  progress::Reporter progress(options->progress_callback,
+                              progress::Phase::REPR_ITERATE,
+                              options->progress_interval);
+
+  // the group order is only needed to estimate the remaining work
+  double order = progress.active() ?
+    _automorphisms.order().convert_to<double>() : 0.0;
+
   for (auto it = _automorphisms.begin(); it != _automorphisms.end(); ++it) {
-    if (timeout::is_set(aborted))
-      throw timeout::AbortedError("min_elem_iterate");
+    poll("min_elem_iterate");
+
+    if (progress.active()) {
+      progress.state.elements = progress.state.processed + 1ULL;
+      progress.state.remaining =
+        order - static_cast<double>(progress.state.elements);
+    }
+
+    progress.tick();
 
     auto const &factors(it.factors());
 
@@ -141,10 +366,13 @@ TaskMapping ArchGraphSystem::min_elem_iterate(TaskMapping const &tasks,
       representative = tasks.permuted(factors, options->offset);
 
     if (is_repr(representative, options, orbits)) {
+      progress.finish();
       return representative;
     }
   }
 
+  progress.finish();
+
   return representative;
 }
 
@@ -159,9 +387,14 @@ TaskMapping ArchGraphSystem::min_elem_orbits(TaskMapping const &tasks,
 
   unprocessed.insert(tasks);
 
+  timeout::Poll poll(aborted);
+
+  progress::Reporter progress(options->progress_callback,
+                              progress::Phase::REPR_ORBITS,
+                              options->progress_interval);
+
   while (!unprocessed.empty()) {
-    if (timeout::is_set(aborted))
-      throw timeout::AbortedError("min_elem_orbits");
+    poll("min_elem_orbits");
 
     auto it(unprocessed.begin());
     TaskMapping current(*it);
@@ -169,25 +402,34 @@ TaskMapping ArchGraphSystem::min_elem_orbits(TaskMapping const &tasks,
 
     processed.insert(current);
 
+    progress.state.elements = processed.size();
+    progress.state.remaining = static_cast<double>(unprocessed.size());
+    progress.tick();
+
     if (current.less_than(representative))
       representative = current;
 
     for (Perm const &gen : _automorphism_generators) {
       TaskMapping next(current.permuted(gen, options->offset));
 
-      if (is_repr(next, options, orbits))
+      if (is_repr(next, options, orbits)) {
+        progress.finish();
         return next;
-      else if (processed.find(next) == processed.end())
+      } else if (processed.find(next) == processed.end()) {
         unprocessed.insert(next);
+      }
     }
   }
 
+  progress.finish();
+
   return representative;
 }
 
 TaskMapping ArchGraphSystem::min_elem_local_search(
   TaskMapping const &tasks,
-  ReprOptions const *options) const
+  ReprOptions const *options,
+  timeout::flag aborted) const
 {
   auto generators(local_search_augment_gens(options));
 
@@ -196,7 +438,17 @@ TaskMapping ArchGraphSystem::min_elem_local_search(
   std::vector<TaskMapping> possible_representatives;
   possible_representatives.reserve(generators.size());
 
+  timeout::Poll poll(aborted);
+
+  progress::Reporter progress(options->progress_callback,
+                              progress::Phase::REPR_LOCAL_SEARCH,
+                              options->progress_interval);
+
   for (;;) {
+    poll("min_elem_local_search");
+
+    progress.tick();
+
     bool stationary = true;
 
     for (Perm const &gen : generators) {
@@ -226,6 +478,8 @@ TaskMapping ArchGraphSystem::min_elem_local_search(
     }
   }
 
+  progress.finish();
+
   return representative;
 }
 
@@ -243,12 +497,13 @@ PermSet ArchGraphSystem::local_search_augment_gens(
 
 TaskMapping ArchGraphSystem::min_elem_local_search_sa(
   TaskMapping const &tasks,
-  ReprOptions const *options) const
+  ReprOptions const *options,
+  timeout::flag aborted) const
 {
   using namespace std::placeholders;
 
   // probability distributions
-  static auto re(util::random_engine());
+  static thread_local auto re(util::random_engine());
 
   std::uniform_real_distribution<> d_prob(0.0, 1.0);
 
@@ -264,7 +519,19 @@ TaskMapping ArchGraphSystem::min_elem_local_search_sa(
   std::vector<unsigned> gen_indices(_automorphism_generators.size());
   std::iota(gen_indices.begin(), gen_indices.end(), 0u);
 
+  timeout::Poll poll(aborted);
+
+  progress::Reporter progress(options->progress_callback,
+                              progress::Phase::REPR_LOCAL_SEARCH_SA,
+                              options->progress_interval);
+
   for (unsigned i = 0u; i < options->local_search_sa_iterations; ++i) {
+    poll("min_elem_local_search_sa");
+
+    progress.state.remaining =
+      static_cast<double>(options->local_search_sa_iterations - i);
+    progress.tick();
+
     // schedule T
     double T = local_search_sa_schedule_T(i, options);
 
@@ -295,6 +562,8 @@ TaskMapping ArchGraphSystem::min_elem_local_search_sa(
     }
   }
 
+  progress.finish();
+
   return representative;
 }
 
@@ -0,0 +1,343 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "arch_graph.hpp"
+#include "arch_graph_automorphisms.hpp"
+#include "arch_graph_cluster.hpp"
+#include "arch_graph_system.hpp"
+#include "arch_uniform_super_graph.hpp"
+#include "binary.hpp"
+#include "bsgs.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+#include "string.hpp"
+
+// Snapshot layout (see binary.hpp, all fields are 32 bit words):
+//
+//   magic ("MPSYMSNP"), version, byte order mark, system
+//
+// where every (sub)system is stored as:
+//
+//   type, structure, automorphisms valid flag, [automorphisms],
+//   number of representative decomposition factors, factors (as systems),
+//   type specific state
+//
+// The structure of architecture graphs is their JSON representation, that of
+// clusters and uniform super graphs is made up of their subsystems and that of
+// explicit automorphism groups is their binary BSGS. Automorphisms are stored
+// as binary BSGSs as well, architecture graphs additionally store the base and
+// strong generators of automorphisms known in advance and uniform super graphs
+// the automorphism groups used to determine representatives.
+
+namespace
+{
+
+using word = std::uint32_t;
+
+char const SNAPSHOT_MAGIC[8] = {'M', 'P', 'S', 'Y', 'M', 'S', 'N', 'P'};
+
+word const SNAPSHOT_VERSION = 2u;
+word const SNAPSHOT_BYTE_ORDER_MARK = 0x01020304u;
+
+enum : word
+{
+  SNAPSHOT_AUTOMORPHISMS,
+  SNAPSHOT_GRAPH,
+  SNAPSHOT_CLUSTER,
+  SNAPSHOT_SUPER_GRAPH
+};
+
+std::shared_ptr<mpsym::internal::ArchGraphAutomorphisms>
+as_automorphisms(std::shared_ptr<mpsym::ArchGraphSystem> const &system)
+{
+  auto automorphisms(
+    std::dynamic_pointer_cast<mpsym::internal::ArchGraphAutomorphisms>(system));
+
+  if (!automorphisms)
+    throw std::runtime_error("malformed snapshot");
+
+  return automorphisms;
+}
+
+} // anonymous namespace
+
+namespace mpsym
+{
+
+using namespace internal;
+
+std::shared_ptr<ArchGraphSystem> ArchGraphSystem::from_binary(
+  char const *data,
+  std::size_t size,
+  AutomorphismOptions const *options)
+{
+  if (size >= sizeof(SNAPSHOT_MAGIC) &&
+      std::memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0) {
+    return from_snapshot(data, size, options);
+  }
+
+  return std::make_shared<ArchGraphAutomorphisms>(
+    PermGroup(BSGS::from_binary(data, size, options)));
+}
+
+std::shared_ptr<ArchGraphSystem> ArchGraphSystem::from_binary_file(
+  std::string const &binary_file,
+  AutomorphismOptions const *options)
+{
+  return from_binary(util::read_file(binary_file), options);
+}
+
+std::shared_ptr<ArchGraphSystem> ArchGraphSystem::from_snapshot(
+  char const *data,
+  std::size_t size,
+  AutomorphismOptions const *options)
+{
+  BinaryReader reader(data, size);
+
+  char magic[sizeof(SNAPSHOT_MAGIC)];
+  for (unsigned i = 0u; i < sizeof(SNAPSHOT_MAGIC) / sizeof(word); ++i) {
+    word w = reader.read();
+    std::memcpy(magic + i * sizeof(word), &w, sizeof(word));
+  }
+
+  if (std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+    throw std::runtime_error("not a snapshot");
+
+  if (reader.read() != SNAPSHOT_VERSION)
+    throw std::runtime_error("unsupported snapshot version");
+
+  if (reader.read() != SNAPSHOT_BYTE_ORDER_MARK)
+    throw std::runtime_error("snapshot has foreign byte order");
+
+  auto system(restore(reader, options));
+
+  if (!reader.done())
+    throw std::runtime_error("trailing snapshot data");
+
+  return system;
+}
+
+std::string ArchGraphSystem::to_snapshot() const
+{
+  BinaryWriter writer;
+
+  writer.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  writer.write(SNAPSHOT_VERSION);
+  writer.write(SNAPSHOT_BYTE_ORDER_MARK);
+
+  snapshot(*this, writer);
+
+  return writer.str();
+}
+
+void ArchGraphSystem::snapshot(ArchGraphSystem const &system,
+                               BinaryWriter &writer)
+{
+  system.snapshot_structure_(writer);
+
+  writer.write(system._automorphisms_valid);
+
+  if (system._automorphisms_valid)
+    system.snapshot_automorphisms_(writer);
+
+  writer.write(system._repr_decomposition.size());
+
+  for (auto const &factor : system._repr_decomposition)
+    snapshot(*factor, writer);
+
+  system.snapshot_state_(writer);
+}
+
+std::shared_ptr<ArchGraphSystem> ArchGraphSystem::restore(
+  BinaryReader &reader,
+  AutomorphismOptions const *options)
+{
+  std::shared_ptr<ArchGraphSystem> system;
+
+  switch (reader.read()) {
+    case SNAPSHOT_AUTOMORPHISMS:
+      {
+        auto bsgs(BSGS::from_binary(reader.read_string(), options));
+
+        system = std::make_shared<ArchGraphAutomorphisms>(PermGroup(bsgs));
+      }
+      break;
+    case SNAPSHOT_GRAPH:
+      system = from_json(reader.read_string());
+      break;
+    case SNAPSHOT_CLUSTER:
+      {
+        auto cluster(std::make_shared<ArchGraphCluster>());
+
+        word num_subsystems = reader.read();
+        for (word i = 0u; i < num_subsystems; ++i)
+          cluster->add_subsystem(restore(reader, options));
+
+        system = cluster;
+      }
+      break;
+    case SNAPSHOT_SUPER_GRAPH:
+      {
+        auto super_graph(restore(reader, options));
+        auto proto(restore(reader, options));
+
+        system = std::make_shared<ArchUniformSuperGraph>(super_graph, proto);
+      }
+      break;
+    default:
+      throw std::runtime_error("malformed snapshot");
+  }
+
+  if (reader.read()) {
+    system->_automorphisms = system->restore_automorphisms_(reader, options);
+    system->_automorphism_generators =
+      system->_automorphisms.generators().with_inverses();
+    system->_automorphisms_valid = true;
+  }
+
+  word num_factors = reader.read();
+  for (word i = 0u; i < num_factors; ++i)
+    system->_repr_decomposition.push_back(restore(reader, options));
+
+  if (num_factors > 0u)
+    system->_repr_decomposition_ready = true;
+
+  system->restore_state_(reader, options);
+
+  return system;
+}
+
+void ArchGraphSystem::snapshot_automorphisms_(BinaryWriter &writer) const
+{ writer.write_string(_automorphisms.bsgs().to_binary()); }
+
+PermGroup ArchGraphSystem::restore_automorphisms_(
+  BinaryReader &reader,
+  AutomorphismOptions const *options)
+{ return PermGroup(BSGS::from_binary(reader.read_string(), options)); }
+
+void ArchGraph::snapshot_structure_(BinaryWriter &writer) const
+{
+  writer.write(SNAPSHOT_GRAPH);
+  writer.write_string(to_json());
+}
+
+void ArchGraph::snapshot_state_(BinaryWriter &writer) const
+{
+  writer.write(static_cast<bool>(_automorphisms_preset));
+
+  if (!_automorphisms_preset)
+    return;
+
+  auto const &base(_automorphisms_preset->base);
+
+  writer.write(base.size());
+  for (unsigned b : base)
+    writer.write(b);
+
+  auto const &strong_generators(_automorphisms_preset->strong_generators);
+
+  writer.write(strong_generators.size());
+  for (auto const &gen : strong_generators)
+    writer.write(gen);
+}
+
+void ArchGraph::restore_state_(BinaryReader &reader,
+                               AutomorphismOptions const *)
+{
+  if (!reader.read())
+    return;
+
+  auto base(reader.read(reader.read()));
+
+  for (unsigned b : base) {
+    if (b >= num_processors())
+      throw std::runtime_error("malformed snapshot");
+  }
+
+  PermSet strong_generators;
+
+  word num_strong_generators = reader.read();
+  for (word i = 0u; i < num_strong_generators; ++i)
+    strong_generators.insert(reader.read_perm(num_processors()));
+
+  _automorphisms_preset = std::make_shared<AutomorphismsPreset const>(
+    AutomorphismsPreset {base, strong_generators});
+}
+
+void ArchGraphCluster::snapshot_structure_(BinaryWriter &writer) const
+{
+  writer.write(SNAPSHOT_CLUSTER);
+  writer.write(_subsystems.size());
+
+  for (auto const &subsystem : _subsystems)
+    snapshot(*subsystem, writer);
+}
+
+void ArchUniformSuperGraph::snapshot_structure_(BinaryWriter &writer) const
+{
+  writer.write(SNAPSHOT_SUPER_GRAPH);
+
+  snapshot(*_subsystem_super_graph, writer);
+  snapshot(*_subsystem_proto, writer);
+}
+
+void ArchUniformSuperGraph::snapshot_state_(BinaryWriter &writer) const
+{
+  writer.write(_sigmas_valid);
+
+  if (!_sigmas_valid)
+    return;
+
+  writer.write(_super_graph_trivial);
+  writer.write(_proto_trivial);
+
+  if (_super_graph_trivial || _proto_trivial) {
+    snapshot(*_sigma_total, writer);
+  } else {
+    snapshot(*_sigma_super_graph, writer);
+
+    writer.write(_sigmas_proto.size());
+    for (auto const &sigma : _sigmas_proto)
+      snapshot(*sigma, writer);
+  }
+}
+
+void ArchUniformSuperGraph::restore_state_(BinaryReader &reader,
+                                           AutomorphismOptions const *options)
+{
+  if (!reader.read())
+    return;
+
+  _super_graph_trivial = reader.read();
+  _proto_trivial = reader.read();
+
+  if (_super_graph_trivial || _proto_trivial) {
+    _sigma_total = as_automorphisms(restore(reader, options));
+  } else {
+    _sigma_super_graph = as_automorphisms(restore(reader, options));
+
+    word num_sigmas_proto = reader.read();
+    for (word i = 0u; i < num_sigmas_proto; ++i)
+      _sigmas_proto.push_back(as_automorphisms(restore(reader, options)));
+  }
+
+  _sigmas_valid = true;
+}
+
+namespace internal
+{
+
+void ArchGraphAutomorphisms::snapshot_structure_(BinaryWriter &writer) const
+{
+  writer.write(SNAPSHOT_AUTOMORPHISMS);
+  writer.write_string(_automorphisms.bsgs().to_binary());
+}
+
+} // namespace internal
+
+} // namespace mpsym
@@ -0,0 +1,497 @@
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+
+#include "arch_graph.hpp"
+#include "bsgs.hpp"
+#include "perm.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+
+// The automorphism groups of meshes and tori follow from the fact that the
+// automorphism group of a connected graph is generated by the automorphisms of
+// the factors of its prime factorization w.r.t. the cartesian product and the
+// transpositions of isomorphic factors. Paths (including K2) and cycles of
+// length other than four are prime, four cycles are K2 x K2. The automorphism
+// group of a complete tree is an iterated wreath product generated by the
+// transpositions of sibling subtrees. Fat trees only differ from complete trees
+// in their channel types, which are uniform on every level, and every tree
+// automorphism preserves levels, so both have the same automorphism group.
+
+namespace
+{
+
+using mpsym::internal::BSGS;
+using mpsym::internal::BSGSOptions;
+using mpsym::internal::Perm;
+using mpsym::internal::PermGroup;
+using mpsym::internal::PermSet;
+
+using channel_list = std::vector<std::pair<unsigned, unsigned>>;
+
+using base_and_strong_generators = std::pair<BSGS::Base, PermSet>;
+
+// explicit transversals of e.g. large tori or hypercubes take up quadratic
+// space in the number of processors, above this degree Schreier trees are
+// used unless requested otherwise
+constexpr unsigned PRESET_SCHREIER_TREES_MIN_DEGREE = 512u;
+
+// the given generators must form a strong generating set relative to the
+// candidate base points, base points with trivial fundamental orbits are
+// skipped
+BSGS::Base nonredundant_base(std::vector<unsigned> const &candidates,
+                             PermSet const &strong_generators)
+{
+  BSGS::Base base;
+
+  PermSet remaining(strong_generators);
+
+  for (unsigned b : candidates) {
+    if (remaining.empty())
+      break;
+
+    PermSet stabilizer;
+    for (auto const &gen : remaining) {
+      if (gen[b] == b)
+        stabilizer.insert(gen);
+    }
+
+    if (stabilizer.size() < remaining.size())
+      base.push_back(b);
+
+    remaining = stabilizer;
+  }
+
+  assert(remaining.empty());
+
+  return base;
+}
+
+class ProductTopology
+{
+  struct Factor
+  {
+    bool cycle;
+    unsigned n;
+
+    bool operator==(Factor const &other) const
+    { return cycle == other.cycle && n == other.n; }
+  };
+
+public:
+  ProductTopology(std::vector<unsigned> const &dims, bool wrap)
+  : _dims(dims),
+    _wrap(wrap)
+  {
+    if (dims.empty())
+      throw std::invalid_argument("topology needs at least one dimension");
+
+    _num_processors = 1u;
+
+    for (unsigned n : dims) {
+      if (n == 0u)
+        throw std::invalid_argument("topology dimensions must be non-zero");
+
+      _num_processors *= n;
+
+      if (wrap && n == 4u) {
+        _factors.push_back({false, 2u});
+        _factors.push_back({false, 2u});
+      } else if (wrap && n > 2u) {
+        _factors.push_back({true, n});
+      } else if (n > 1u) {
+        _factors.push_back({false, n});
+      }
+    }
+  }
+
+  unsigned num_processors() const
+  { return _num_processors; }
+
+  channel_list channels() const
+  {
+    channel_list res;
+
+    unsigned stride = 1u;
+    for (auto d = _dims.size(); d-- > 0u;) {
+      unsigned n = _dims[d];
+
+      for (unsigned pe = 0u; pe < _num_processors; ++pe) {
+        unsigned x = (pe / stride) % n;
+
+        if (x + 1u < n)
+          res.emplace_back(pe, pe + stride);
+        else if (_wrap && n > 2u)
+          res.emplace_back(pe - x * stride, pe);
+      }
+
+      stride *= n;
+    }
+
+    return res;
+  }
+
+  base_and_strong_generators automorphisms() const
+  {
+    PermSet strong_generators;
+
+    for (unsigned f = 0u; f < _factors.size(); ++f) {
+      unsigned n = _factors[f].n;
+
+      if (_factors[f].cycle) {
+        add_generator(strong_generators,
+                      [f, n](std::vector<unsigned> &y){ y[f] = (y[f] + 1u) % n; });
+
+        add_generator(strong_generators,
+                      [f, n](std::vector<unsigned> &y){ y[f] = (n - y[f]) % n; });
+      } else {
+        add_generator(strong_generators,
+                      [f, n](std::vector<unsigned> &y){ y[f] = n - 1u - y[f]; });
+      }
+    }
+
+    std::vector<unsigned> candidates {processor(std::vector<unsigned>(_factors.size(), 0u))};
+
+    std::vector<bool> done(_factors.size(), false);
+
+    for (unsigned f = 0u; f < _factors.size(); ++f) {
+      if (done[f])
+        continue;
+
+      unsigned prev = f;
+      for (unsigned g = f; g < _factors.size(); ++g) {
+        if (!(_factors[g] == _factors[f]))
+          continue;
+
+        if (g != prev) {
+          add_generator(strong_generators,
+                        [prev, g](std::vector<unsigned> &y){ std::swap(y[prev], y[g]); });
+        }
+
+        std::vector<unsigned> unit(_factors.size(), 0u);
+        unit[g] = 1u;
+
+        candidates.push_back(processor(unit));
+
+        done[g] = true;
+        prev = g;
+      }
+    }
+
+    strong_generators.insert_inverses();
+
+    return {nonredundant_base(candidates, strong_generators),
+            strong_generators};
+  }
+
+private:
+  std::vector<unsigned> factor_coordinates(unsigned pe) const
+  {
+    std::vector<unsigned> y(_factors.size());
+
+    auto f = _factors.size();
+
+    for (auto d = _dims.size(); d-- > 0u;) {
+      unsigned n = _dims[d];
+      unsigned x = pe % n;
+      pe /= n;
+
+      if (_wrap && n == 4u) {
+        // gray code, adjacent positions on the cycle differ in one bit
+        y[--f] = (x >> 1u) ^ (x & 1u);
+        y[--f] = x >> 1u;
+      } else if (n > 1u) {
+        y[--f] = x;
+      }
+    }
+
+    return y;
+  }
+
+  unsigned processor(std::vector<unsigned> const &y) const
+  {
+    unsigned pe = 0u;
+
+    unsigned f = 0u;
+
+    for (unsigned n : _dims) {
+      unsigned x;
+
+      if (_wrap && n == 4u) {
+        unsigned hi = y[f++];
+        unsigned lo = y[f++];
+        x = (hi << 1u) | (hi ^ lo);
+      } else if (n > 1u) {
+        x = y[f++];
+      } else {
+        x = 0u;
+      }
+
+      pe = pe * n + x;
+    }
+
+    return pe;
+  }
+
+  void add_generator(PermSet &generators,
+                     std::function<void(std::vector<unsigned> &)> const &f) const
+  {
+    std::vector<unsigned> images(_num_processors);
+
+    for (unsigned pe = 0u; pe < _num_processors; ++pe) {
+      auto y(factor_coordinates(pe));
+      f(y);
+      images[pe] = processor(y);
+    }
+
+    generators.insert(Perm(images));
+  }
+
+  std::vector<unsigned> _dims;
+  bool _wrap;
+
+  unsigned _num_processors;
+  std::vector<Factor> _factors;
+};
+
+class TreeTopology
+{
+public:
+  TreeTopology(unsigned arity, unsigned levels)
+  : _arity(arity)
+  {
+    if (arity < 2u)
+      throw std::invalid_argument("tree arity must be at least two");
+
+    unsigned level_size = 1u;
+    for (unsigned l = 0u; l < levels; ++l)
+      level_size *= arity;
+
+    _num_leaves = level_size;
+
+    for (unsigned l = 0u; l <= levels; ++l) {
+      _level_offsets.push_back(_num_nodes);
+      _num_nodes += level_size;
+      level_size /= arity;
+    }
+  }
+
+  unsigned num_leaves() const
+  { return _num_leaves; }
+
+  unsigned num_switches() const
+  { return _num_nodes - _num_leaves; }
+
+  unsigned levels() const
+  { return static_cast<unsigned>(_level_offsets.size()) - 1u; }
+
+  // channels between level l and its parent level (level 0 are the leaves)
+  channel_list channels(unsigned l) const
+  {
+    channel_list res;
+
+    for (unsigned i = 0u; i < level_size(l); ++i)
+      res.emplace_back(node(l, i), node(l + 1u, i / _arity));
+
+    return res;
+  }
+
+  base_and_strong_generators automorphisms() const
+  {
+    PermSet strong_generators;
+
+    for (unsigned l = 1u; l < _level_offsets.size(); ++l) {
+      for (unsigned i = 0u; i < level_size(l); ++i) {
+        for (unsigned c = 0u; c + 1u < _arity; ++c)
+          strong_generators.insert(swap_subtrees(l - 1u, i * _arity + c));
+      }
+    }
+
+    std::vector<unsigned> candidates(_num_leaves);
+    for (unsigned i = 0u; i < _num_leaves; ++i)
+      candidates[i] = i;
+
+    return {nonredundant_base(candidates, strong_generators),
+            strong_generators};
+  }
+
+private:
+  unsigned level_size(unsigned l) const
+  {
+    return (l + 1u < _level_offsets.size() ? _level_offsets[l + 1u] : _num_nodes)
+           - _level_offsets[l];
+  }
+
+  unsigned node(unsigned l, unsigned i) const
+  { return _level_offsets[l] + i; }
+
+  // swap the subtrees rooted in the i-th and (i + 1)-th node on level l
+  Perm swap_subtrees(unsigned l, unsigned i) const
+  {
+    std::vector<unsigned> images(_num_nodes);
+    for (unsigned x = 0u; x < _num_nodes; ++x)
+      images[x] = x;
+
+    unsigned width = 1u;
+    for (unsigned m = l + 1u; m-- > 0u;) {
+      unsigned first = i * width;
+
+      for (unsigned j = 0u; j < width; ++j) {
+        images[node(m, first + j)] = node(m, first + width + j);
+        images[node(m, first + width + j)] = node(m, first + j);
+      }
+
+      width *= _arity;
+    }
+
+    return Perm(images);
+  }
+
+  unsigned _arity;
+
+  unsigned _num_leaves;
+  unsigned _num_nodes = 0u;
+  std::vector<unsigned> _level_offsets;
+};
+
+} // anonymous namespace
+
+namespace mpsym
+{
+
+using namespace internal;
+
+std::shared_ptr<ArchGraph> ArchGraph::mesh(std::vector<unsigned> const &dims,
+                                           std::string const &pl,
+                                           std::string const &cl)
+{
+  ProductTopology topology(dims, false);
+
+  auto ag(std::make_shared<ArchGraph>(false));
+
+  ag->add_processors_unchecked(topology.num_processors(),
+                               ag->new_processor_type(pl));
+
+  ag->add_channels_unchecked(topology.channels(), ag->new_channel_type(cl));
+
+  auto automorphisms(topology.automorphisms());
+  ag->set_automorphisms_preset(automorphisms.first, automorphisms.second);
+
+  return ag;
+}
+
+std::shared_ptr<ArchGraph> ArchGraph::torus(std::vector<unsigned> const &dims,
+                                            std::string const &pl,
+                                            std::string const &cl)
+{
+  ProductTopology topology(dims, true);
+
+  auto ag(std::make_shared<ArchGraph>(false));
+
+  ag->add_processors_unchecked(topology.num_processors(),
+                               ag->new_processor_type(pl));
+
+  ag->add_channels_unchecked(topology.channels(), ag->new_channel_type(cl));
+
+  auto automorphisms(topology.automorphisms());
+  ag->set_automorphisms_preset(automorphisms.first, automorphisms.second);
+
+  return ag;
+}
+
+std::shared_ptr<ArchGraph> ArchGraph::hypercube(unsigned dim,
+                                                std::string const &pl,
+                                                std::string const &cl)
+{
+  if (dim == 0u)
+    throw std::invalid_argument("hypercube dimension must be non-zero");
+
+  return mesh(std::vector<unsigned>(dim, 2u), pl, cl);
+}
+
+std::shared_ptr<ArchGraph> ArchGraph::fat_tree(unsigned arity,
+                                               unsigned levels,
+                                               std::string const &pl,
+                                               std::string const &sl,
+                                               std::string const &cl)
+{
+  TreeTopology topology(arity, levels);
+
+  auto ag(std::make_shared<ArchGraph>(false));
+
+  ag->add_processors_unchecked(topology.num_leaves(),
+                               ag->new_processor_type(pl));
+
+  if (topology.num_switches() > 0u) {
+    ag->add_processors_unchecked(topology.num_switches(),
+                                 ag->new_processor_type(sl));
+  }
+
+  // a channel carries the combined bandwidth of all leaf channels below it
+  unsigned width = 1u;
+  for (unsigned l = 0u; l < topology.levels(); ++l) {
+    ag->add_channels_unchecked(topology.channels(l),
+                               ag->new_channel_type(cl + std::to_string(width)));
+    width *= arity;
+  }
+
+  auto automorphisms(topology.automorphisms());
+  ag->set_automorphisms_preset(automorphisms.first, automorphisms.second);
+
+  return ag;
+}
+
+void ArchGraph::set_automorphisms_preset(BSGS::Base const &base,
+                                         PermSet const &strong_generators)
+{
+  reset_automorphisms();
+
+  _automorphisms_preset = std::make_shared<AutomorphismsPreset const>(
+    AutomorphismsPreset {base, strong_generators});
+}
+
+PermGroup ArchGraph::automorphisms_preset(AutomorphismOptions const *options)
+{
+  auto bsgs_options(BSGSOptions::fill_defaults(options));
+
+  if (!options && num_processors() >= PRESET_SCHREIER_TREES_MIN_DEGREE)
+    bsgs_options.transversals = BSGSOptions::Transversals::SCHREIER_TREES;
+
+  return PermGroup(BSGS(num_processors(),
+                        _automorphisms_preset->base,
+                        _automorphisms_preset->strong_generators,
+                        &bsgs_options));
+}
+
+void ArchGraph::add_processors_unchecked(unsigned n, ProcessorType pt)
+{
+  reset_automorphisms();
+  _automorphisms_preset.reset();
+
+  _processor_type_instances[pt] += n;
+
+  VertexProperty vp {pt};
+  for (unsigned i = 0u; i < n; ++i)
+    boost::add_vertex(vp, _adj);
+}
+
+void ArchGraph::add_channels_unchecked(channel_list const &channels,
+                                       ChannelType ct)
+{
+  reset_automorphisms();
+  _automorphisms_preset.reset();
+
+  _channel_type_instances[ct] += channels.size();
+
+  EdgeProperty ep {ct};
+  for (auto const &ch : channels)
+    boost::add_edge(ch.first, ch.second, ep, _adj);
+}
+
+} // namespace mpsym
@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <memory>
 #include <numeric>
 #include <sstream>
@@ -12,6 +13,7 @@
 #include "perm_set.hpp"
 #include "task_mapping.hpp"
 #include "task_mapping_orbit.hpp"
+#include "util.hpp"
 
 namespace mpsym
 {
@@ -172,6 +174,22 @@ ArchUniformSuperGraph::init_repr_(AutomorphismOptions const *options,
   _sigmas_valid = true;
 }
 
+void
+ArchUniformSuperGraph::prepare_repr_(AutomorphismOptions const *,
+                                     timeout::flag aborted)
+{
+  // representatives are determined via the wreath product action only
+  if (_super_graph_trivial || _proto_trivial) {
+    _sigma_total->prepare_repr(nullptr, aborted);
+    return;
+  }
+
+  for (auto &sigma : _sigmas_proto)
+    sigma->prepare_repr(nullptr, aborted);
+
+  _sigma_super_graph->prepare_repr(nullptr, aborted);
+}
+
 bool
 ArchUniformSuperGraph::repr_ready_() const
 {
@@ -188,6 +206,21 @@ ArchUniformSuperGraph::reset_repr_()
   _sigmas_valid = false;
 }
 
+std::size_t
+ArchUniformSuperGraph::memory_usage_() const
+{
+  auto sigma_memory_usage =
+    [](std::shared_ptr<internal::ArchGraphAutomorphisms> const &sigma)
+    { return sigma ? sigma->memory_usage() : 0u; };
+
+  return memory_usage_automorphisms() +
+         _subsystem_super_graph->memory_usage() +
+         _subsystem_proto->memory_usage() +
+         sigma_memory_usage(_sigma_total) +
+         sigma_memory_usage(_sigma_super_graph) +
+         util::container_memory_usage(_sigmas_proto, sigma_memory_usage);
+}
+
 TaskMapping
 ArchUniformSuperGraph::repr_(TaskMapping const &mapping,
                              ReprOptions const *options,
@@ -205,4 +238,21 @@ ArchUniformSuperGraph::repr_(TaskMapping const &mapping,
   return _sigma_super_graph->repr(representative, options, aborted);
 }
 
+TaskMapping
+ArchUniformSuperGraph::repr_prepared_(TaskMapping const &mapping,
+                                      ReprOptions const *options,
+                                      TMORs *,
+                                      timeout::flag aborted) const
+{
+  TaskMapping representative(mapping);
+
+  if (_super_graph_trivial || _proto_trivial)
+    return _sigma_total->repr_prepared(representative, options, aborted);
+
+  for (auto const &sigma : _sigmas_proto)
+    representative = sigma->repr_prepared(representative, options, aborted);
+
+  return _sigma_super_graph->repr_prepared(representative, options, aborted);
+}
+
 } // namespace mpsym
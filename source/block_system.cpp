@@ -5,7 +5,7 @@
 #include <numeric>
 #include <ostream>
 #include <stdexcept>
-#include <unordered_map>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -17,6 +17,15 @@
 #include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
+#include "timeout.hpp"
+
+namespace
+{
+
+// minimum number of minimal block systems computed by each thread
+constexpr unsigned MINIMAL_BLOCK_SYSTEMS_MIN_PER_THREAD = 16u;
+
+} // anonymous namespace
 
 namespace mpsym
 {
@@ -92,62 +101,21 @@ PermSet BlockSystem::block_stabilizers(PermSet const &generators,
 BlockSystem BlockSystem::minimal(PermSet const &generators,
                                  std::vector<unsigned> const &initial_block)
 {
-  assert(initial_block.size() >= 2u);
-
-  std::vector<unsigned> classpath(generators.degree());
-  std::vector<unsigned> cardinalities(generators.degree());
-  std::vector<unsigned> queue;
-
   DBG(DEBUG) << "Finding minimal block system for:";
   DBG(DEBUG) << generators;
 
-  DBG(TRACE) << "Initial block: " << initial_block;
-
-  for (auto i = 0u; i < generators.degree(); ++i) {
-    classpath[i] = i;
-    cardinalities[i] = 1u;
-  }
-
-  for (auto i = 0u; i < initial_block.size() - 1u; ++i) {
-    unsigned tmp = initial_block[i + 1u];
-
-    classpath[tmp] = initial_block[0];
-	queue.push_back(tmp);
-  }
-
-  cardinalities[initial_block[0]] = static_cast<unsigned>(initial_block.size());
-
-  DBG(TRACE) << "Initial classpath: " << classpath;
-  DBG(TRACE) << "Initial cardinalities: " << cardinalities;
-  DBG(TRACE) << "Initial queue: " << queue;
-
-  unsigned i = 0u;
-  unsigned l = initial_block.size() - 2u;
-
-  while (i <= l) {
-    unsigned gamma = queue[i++];
-    DBG(TRACE) << "Gamma: " << gamma;
-
-    for (Perm const &gen : generators) {
-      DBG(TRACE) << "Gen: " << gen;
-
-      unsigned c1 = gen[gamma];
-      unsigned c2 = gen[minimal_find_rep(gamma, classpath)];
-
-      DBG(TRACE) << "Considering classes " << c1 << " and " << c2;
+  std::vector<unsigned> classpath;
+  std::vector<unsigned> cardinalities;
+  std::vector<unsigned> queue;
 
-      if (minimal_merge_classes(c1, c2, classpath, cardinalities, queue))
-        ++l;
-    }
+  if (!minimal_classpath(generators,
+                         initial_block,
+                         classpath,
+                         cardinalities,
+                         queue)) {
+    classpath.assign(generators.degree(), 0u);
   }
 
-  for (auto i = 0u; i < generators.degree(); ++i)
-    minimal_find_rep(i, classpath);
-
-  minimal_compress_classpath(classpath);
-
-  DBG(TRACE) << "Final classpath is: " << classpath;
-
   BlockSystem res(classpath);
 
   DBG(DEBUG) << "=> Resulting minimal block system:";
@@ -157,7 +125,8 @@ BlockSystem BlockSystem::minimal(PermSet const &generators,
 }
 
 std::vector<BlockSystem> BlockSystem::non_trivial(PermGroup const &pg,
-                                                  bool assume_transitivity)
+                                                  bool assume_transitivity,
+                                                  timeout::flag aborted)
 {
   assert((!assume_transitivity || pg.is_transitive()) &&
     "transitivity assumption correct");
@@ -175,8 +144,8 @@ std::vector<BlockSystem> BlockSystem::non_trivial(PermGroup const &pg,
     DBG(TRACE) << "Group " << (transitive ? "is" : "is not") << " transitive";
   }
 
-  auto res(transitive ? non_trivial_transitive(pg)
-                      : non_trivial_non_transitive(pg));
+  auto res(transitive ? non_trivial_transitive(pg, aborted)
+                      : non_trivial_non_transitive(pg, aborted));
 
   DBG(DEBUG) << "=> Resulting non-trivial block systems:";
 #ifndef NDEBUG
@@ -297,6 +266,76 @@ BlockSystem BlockSystem::from_block(PermSet const &generators,
   throw std::logic_error("unreachable");
 }
 
+bool BlockSystem::minimal_classpath(PermSet const &generators,
+                                    std::vector<unsigned> const &initial_block,
+                                    std::vector<unsigned> &classpath,
+                                    std::vector<unsigned> &cardinalities,
+                                    std::vector<unsigned> &queue)
+{
+  assert(initial_block.size() >= 2u);
+
+  unsigned degree = generators.degree();
+
+  // buffers are reused between calls
+  classpath.resize(degree);
+  std::iota(classpath.begin(), classpath.end(), 0u);
+
+  cardinalities.assign(degree, 1u);
+
+  queue.clear();
+
+  DBG(TRACE) << "Initial block: " << initial_block;
+
+  for (auto i = 0u; i < initial_block.size() - 1u; ++i) {
+    unsigned tmp = initial_block[i + 1u];
+
+    classpath[tmp] = initial_block[0];
+    queue.push_back(tmp);
+  }
+
+  cardinalities[initial_block[0]] = static_cast<unsigned>(initial_block.size());
+
+  DBG(TRACE) << "Initial classpath: " << classpath;
+  DBG(TRACE) << "Initial cardinalities: " << cardinalities;
+  DBG(TRACE) << "Initial queue: " << queue;
+
+  unsigned i = 0u;
+  unsigned l = initial_block.size() - 2u;
+
+  while (i <= l) {
+    unsigned gamma = queue[i++];
+    DBG(TRACE) << "Gamma: " << gamma;
+
+    for (Perm const &gen : generators) {
+      DBG(TRACE) << "Gen: " << gen;
+
+      unsigned c1 = gen[gamma];
+      unsigned c2 = gen[minimal_find_rep(gamma, classpath)];
+
+      DBG(TRACE) << "Considering classes " << c1 << " and " << c2;
+
+      if (minimal_merge_classes(c1, c2, classpath, cardinalities, queue)) {
+        // stop as soon as all points have been merged into a single block
+        if (cardinalities[minimal_find_rep(c1, classpath)] == degree) {
+          DBG(TRACE) << "Minimal block system is trivial";
+          return false;
+        }
+
+        ++l;
+      }
+    }
+  }
+
+  for (auto i = 0u; i < degree; ++i)
+    minimal_find_rep(i, classpath);
+
+  minimal_compress_classpath(classpath);
+
+  DBG(TRACE) << "Final classpath is: " << classpath;
+
+  return true;
+}
+
 unsigned BlockSystem::minimal_find_rep(unsigned k,
                                        std::vector<unsigned> &classpath)
 {
@@ -357,59 +396,163 @@ bool BlockSystem::minimal_merge_classes(unsigned k1,
 
 void BlockSystem::minimal_compress_classpath(std::vector<unsigned> &classpath)
 {
-  std::unordered_map<unsigned, unsigned> compression;
+  // every class representative is also a class member
+  std::vector<unsigned> compression(classpath.size(), 0u);
 
   unsigned i = 0u;
   for (unsigned j : classpath) {
-    if (compression.find(j) == compression.end())
-      compression[j] = i++;
+    if (compression[j] == 0u)
+      compression[j] = ++i;
   }
 
   for (unsigned &j : classpath)
-    j = compression[j];
+    j = compression[j] - 1u;
 }
 
 std::vector<BlockSystem> BlockSystem::non_trivial_transitive(
-  PermGroup const &pg)
+  PermGroup const &pg,
+  timeout::flag aborted)
 {
+  if (pg.is_trivial())
+    return {};
+
   // first base element
   unsigned first_base_elem = pg.bsgs().base_point(0);
   DBG(TRACE) << "First base element is: " << first_base_elem;
 
   // generators of stabilizer subgroup for first base element
-  PermSet stab = pg.bsgs().stabilizers(1);
+  PermSet stab;
+  if (pg.bsgs().base_size() > 1u)
+    stab = pg.bsgs().stabilizers(1);
+
+  // candidate points, one per orbit of the stabilizer subgroup
+  std::vector<unsigned> candidates;
 
   if (stab.empty()) {
     DBG(TRACE) << "No generators stabilizing first base element";
-    return {};
+
+    for (unsigned x = 0u; x < pg.degree(); ++x) {
+      if (x != first_base_elem)
+        candidates.push_back(x);
+    }
+
+  } else {
+    DBG(TRACE) << "Generators stabilizing first base element:";
+    DBG(TRACE) << stab;
+
+    for (auto const &orbit : OrbitPartition(stab.degree(), stab)) {
+      if (*orbit.begin() != first_base_elem)
+        candidates.push_back(*orbit.begin());
+    }
   }
 
-  DBG(TRACE) << "Generators stabilizing first base element:";
-  DBG(TRACE) << stab;
+  // find minimal blocksystems corresponding to all candidates
+  auto classpaths(non_trivial_minimal_classpaths(pg.generators(),
+                                                 first_base_elem,
+                                                 candidates,
+                                                 aborted));
 
   std::vector<BlockSystem> res;
+  std::vector<std::vector<unsigned> const *> found;
 
-  // iterate over orbit partition of stabilizer subgroup
-  for (auto const &orbit : OrbitPartition(stab.degree(), stab)) {
-    if (*orbit.begin() == first_base_elem)
+  for (auto const &classpath : classpaths) {
+    if (classpath.empty())
       continue;
 
-    // find minimal blocksystem corresponding to orbit
-    auto bs(BlockSystem::minimal(pg.generators(),
-                                 {first_base_elem, *orbit.begin()}));
+    // different candidates can lead to the same blocksystem, these are only
+    // detected here, after the minimal blocksystems for all candidates have
+    // been determined
+    bool duplicate = false;
+    for (auto const *other : found) {
+      if (*other == classpath) {
+        duplicate = true;
+        break;
+      }
+    }
+
+    if (duplicate)
+      continue;
+
+    BlockSystem bs(classpath);
 
     if (!bs.trivial()) {
       DBG(TRACE) << "Found blocksystem:";
       DBG(TRACE) << bs;
       res.push_back(bs);
     }
+
+    found.push_back(&classpath);
   }
 
   return res;
 }
 
+std::vector<std::vector<unsigned>> BlockSystem::non_trivial_minimal_classpaths(
+  PermSet const &generators,
+  unsigned first_base_elem,
+  std::vector<unsigned> const &candidates,
+  timeout::flag aborted)
+{
+  std::vector<std::vector<unsigned>> classpaths(candidates.size());
+
+  // worker threads can't throw, they stop early and the flag is checked again
+  // once all of them have been joined
+  auto find_classpaths = [&](unsigned first, unsigned last) {
+    std::vector<unsigned> cardinalities;
+    std::vector<unsigned> queue;
+
+    timeout::Poll poll(aborted, 1u);
+
+    for (unsigned i = first; i < last; ++i) {
+      if (poll.expired())
+        return;
+
+      if (!minimal_classpath(generators,
+                             {first_base_elem, candidates[i]},
+                             classpaths[i],
+                             cardinalities,
+                             queue)) {
+        classpaths[i].clear();
+      }
+    }
+  };
+
+  unsigned num_threads = std::thread::hardware_concurrency();
+  unsigned max_threads = static_cast<unsigned>(
+    candidates.size() / MINIMAL_BLOCK_SYSTEMS_MIN_PER_THREAD);
+
+  num_threads = std::max(1u, std::min(num_threads, max_threads));
+
+  if (num_threads == 1u) {
+    find_classpaths(0u, candidates.size());
+    timeout::check(aborted, "block_systems");
+
+    return classpaths;
+  }
+
+  unsigned chunk = (candidates.size() + num_threads - 1u) / num_threads;
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 1u; t < num_threads; ++t) {
+    unsigned first = std::min<unsigned>(t * chunk, candidates.size());
+    unsigned last = std::min<unsigned>(first + chunk, candidates.size());
+
+    threads.emplace_back(find_classpaths, first, last);
+  }
+
+  find_classpaths(0u, std::min<unsigned>(chunk, candidates.size()));
+
+  for (auto &thread : threads)
+    thread.join();
+
+  timeout::check(aborted, "block_systems");
+
+  return classpaths;
+}
+
 std::vector<BlockSystem> BlockSystem::non_trivial_non_transitive(
-  PermGroup const &pg)
+  PermGroup const &pg,
+  timeout::flag aborted)
 {
   OrbitPartition orbits(pg.degree(), pg.generators());
 
@@ -434,8 +577,11 @@ std::vector<BlockSystem> BlockSystem::non_trivial_non_transitive(
 
     domain_offsets[i] = orbit_low;
 
+    auto in_orbit = [&](unsigned x)
+    { return orbits.partition_index(x) == static_cast<int>(i); };
+
     for (Perm const &gen : pg.generators()) {
-      Perm perm(gen.restricted(orbits[i].begin(), orbits[i].end()));
+      Perm perm(gen.restricted_if(in_orbit));
 
       if (!perm.id())
         restricted_gens.insert(perm.normalized(orbit_low, orbit_high));
@@ -445,7 +591,7 @@ std::vector<BlockSystem> BlockSystem::non_trivial_non_transitive(
     DBG(TRACE) << restricted_gens;
 
     PermGroup pg_restricted(orbit_high - orbit_low + 1u, restricted_gens);
-    partial_blocksystems[i] = non_trivial(pg_restricted, true);
+    partial_blocksystems[i] = non_trivial(pg_restricted, true, aborted);
 
     // append trivial blocksystem {{x} | x in orbit}
     std::vector<unsigned> trivial_classes(orbits[i].size());
@@ -464,7 +610,8 @@ std::vector<BlockSystem> BlockSystem::non_trivial_non_transitive(
   auto blocksystem_representatives(
     non_trivial_find_representatives(pg.generators(),
                                      partial_blocksystems,
-                                     domain_offsets));
+                                     domain_offsets,
+                                     aborted));
 
   return non_trivial_from_representatives(pg.generators(),
                                           blocksystem_representatives);
@@ -473,17 +620,22 @@ std::vector<BlockSystem> BlockSystem::non_trivial_non_transitive(
 std::vector<BlockSystem::Block> BlockSystem::non_trivial_find_representatives(
   PermSet const &generators,
   std::vector<std::vector<BlockSystem>> const &partial_blocksystems,
-  std::vector<unsigned> const &domain_offsets)
+  std::vector<unsigned> const &domain_offsets,
+  timeout::flag aborted)
 {
   DBG(TRACE) << "Finding block system representatives";
 
   std::vector<Block> res;
 
+  timeout::Poll poll(aborted);
+
   std::function<void(std::vector<BlockSystem const *> const &, unsigned, bool)>
   recurse = [&](std::vector<BlockSystem const *> const &current_blocksystems,
                 unsigned i,
                 bool one_trivial)
   {
+    poll("block_systems");
+
     if (i == partial_blocksystems.size()) {
       DBG(TRACE) << "Considering block system combination:";
 #ifndef NDEBUG
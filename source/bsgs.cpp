@@ -13,6 +13,8 @@
 #include "bsgs.hpp"
 #include "dbg.hpp"
 #include "dump.hpp"
+#include "instrument.hpp"
+#include "memory.hpp"
 #include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
@@ -53,6 +55,19 @@ void BSGSTransversalsBase::update_schreier_structure(
   _schreier_structures.push_back(ss);
 }
 
+void BSGSTransversalsBase::restore_schreier_structure(
+  unsigned i, std::shared_ptr<SchreierStructure> ss)
+{
+  if (i < _schreier_structures.size()) {
+    _schreier_structures[i].swap(ss);
+    return;
+  }
+
+  assert(i == _schreier_structures.size());
+
+  _schreier_structures.push_back(ss);
+}
+
 void BSGSTransversalsBase::insert_schreier_structure(
   unsigned i, unsigned root, unsigned degree, PermSet const &generators)
 {
@@ -187,6 +202,8 @@ PermSet BSGS::stabilizers(unsigned i) const
 
 std::pair<Perm, unsigned> BSGS::strip(Perm const &perm, unsigned offs) const
 {
+  INSTRUMENT_SCOPE(STRIP);
+
   Perm result(perm);
 
   for (unsigned i = offs; i < base_size(); ++i) {
@@ -207,11 +224,86 @@ bool BSGS::strips_completely(Perm const &perm) const
   return strip_result.first.id() && strip_result.second == base_size() + 1u;
 }
 
+std::vector<BSGS::LevelMemoryUsage> BSGS::level_memory_usage() const
+{
+  std::vector<LevelMemoryUsage> res(base_size());
+
+  for (unsigned i = 0u; i < base_size(); ++i) {
+    auto ss(schreier_structure(i));
+
+    res[i].transversals = ss->memory_usage_transversals();
+    res[i].labels = ss->memory_usage_labels();
+    res[i].orbit = ss->memory_usage_orbit();
+  }
+
+  return res;
+}
+
+std::size_t BSGS::memory_usage() const
+{
+  std::size_t res = util::container_memory_usage(_base) +
+                    _strong_generators.memory_usage();
+
+  for (auto const &level : level_memory_usage())
+    res += level.total();
+
+  return res + memory_usage_strip_tables();
+}
+
+std::size_t BSGS::memory_usage(BSGS const &shared_with) const
+{
+  std::size_t res = util::container_memory_usage(_base) +
+                    _strong_generators.memory_usage();
+
+  auto levels(level_memory_usage());
+
+  for (unsigned i = 0u; i < base_size(); ++i) {
+    if (i < shared_with.base_size() &&
+        schreier_structure(i) == shared_with.schreier_structure(i)) {
+      continue;
+    }
+
+    res += levels[i].total();
+  }
+
+  auto tables(std::atomic_load(&_strip_tables));
+
+  if (tables != std::atomic_load(&shared_with._strip_tables))
+    res += memory_usage_strip_tables();
+
+  return res;
+}
+
+std::size_t BSGS::memory_usage_strip_tables() const
+{
+  auto tables(std::atomic_load(&_strip_tables));
+
+  if (!tables)
+    return 0u;
+
+  std::size_t res = 0u;
+
+  for (unsigned i = 0u; i < tables->orbit_indices.size(); ++i) {
+    res += util::container_memory_usage(tables->orbit_indices[i]) +
+           util::container_memory_usage(tables->inverse_transversals[i]);
+  }
+
+  return res;
+}
+
 void BSGS::extend_base(unsigned bp)
-{ _base.push_back(bp); }
+{
+  INSTRUMENT_COUNT(BASE_EXTENSION);
+
+  _base.push_back(bp);
+}
 
 void BSGS::extend_base(unsigned bp, unsigned i)
-{ _base.insert(_base.begin() + i, bp); }
+{
+  INSTRUMENT_COUNT(BASE_EXTENSION);
+
+  _base.insert(_base.begin() + i, bp);
+}
 
 void BSGS::transversals_init(BSGSOptions const *options)
 {
@@ -271,12 +363,12 @@ void BSGS::construct_unknown(PermSet const &generators,
       schreier_sims_random(generators, options, aborted);
       break;
     case BSGSOptions::Construction::SOLVE:
-      solve(generators);
+      solve(generators, aborted);
       break;
   }
 
   if (options->reduce_gens)
-    reduce_gens();
+    reduce_gens(aborted);
 }
 
 std::ostream &operator<<(std::ostream &os, BSGS const &bsgs)
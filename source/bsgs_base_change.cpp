@@ -11,6 +11,7 @@
 #include "perm_set.hpp"
 #include "schreier_generator_queue.hpp"
 #include "schreier_structure.hpp"
+#include "timeout.hpp"
 
 namespace mpsym
 {
@@ -18,14 +19,18 @@ namespace mpsym
 namespace internal
 {
 
-void BSGS::base_change(std::vector<unsigned> prefix)
+void BSGS::base_change(std::vector<unsigned> prefix, timeout::flag aborted)
 {
   DBG(DEBUG) << "Appending prefix " << prefix << " to base " << _base;
 
+  strip_tables_reset();
+
   Perm conj(degree());
   Perm conj_inv(degree());
 
   for (auto i = 0u; i < prefix.size(); ++i) {
+    timeout::check(aborted, "base_change");
+
     unsigned target = conj_inv[prefix[i]];
 
     if (i >= base_size()) {
@@ -0,0 +1,254 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "binary.hpp"
+#include "bsgs.hpp"
+#include "perm.hpp"
+#include "perm_set.hpp"
+#include "schreier_structure.hpp"
+#include "string.hpp"
+
+// Binary BSGS layout (see binary.hpp, all fields are 32 bit words):
+//
+//   magic ("MPSYMBSG"), version, byte order mark, degree, flags,
+//   base size, number of strong generators, length of decimal order string,
+//   order string (zero padded to a multiple of four bytes),
+//   base points,
+//   strong generators (as image vectors),
+//   for every base point: number of labels, labels (as image vectors),
+//                         orbit size, orbit nodes, edge destinations,
+//                         edge labels
+//
+// The orbit nodes are stored in the order in which the schreier structure
+// edges have to be recreated, the root comes first and has no incoming edge.
+
+namespace
+{
+
+using word = std::uint32_t;
+
+char const BINARY_MAGIC[8] = {'M', 'P', 'S', 'Y', 'M', 'B', 'S', 'G'};
+
+word const BINARY_VERSION = 1u;
+word const BINARY_BYTE_ORDER_MARK = 0x01020304u;
+
+word const BINARY_FLAG_SYMMETRIC = 1u << 0;
+word const BINARY_FLAG_ALTERNATING = 1u << 1;
+
+word const NO_EDGE = std::numeric_limits<word>::max();
+
+} // anonymous namespace
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+BSGS BSGS::from_binary(char const *data,
+                       std::size_t size,
+                       BSGSOptions const *options_)
+{
+  BinaryReader reader(data, size);
+
+  // header
+  char magic[sizeof(BINARY_MAGIC)];
+  for (unsigned i = 0u; i < sizeof(BINARY_MAGIC) / sizeof(word); ++i) {
+    word w = reader.read();
+    std::memcpy(magic + i * sizeof(word), &w, sizeof(word));
+  }
+
+  if (std::memcmp(magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+    throw std::runtime_error("not a BSGS binary");
+
+  if (reader.read() != BINARY_VERSION)
+    throw std::runtime_error("unsupported BSGS binary version");
+
+  if (reader.read() != BINARY_BYTE_ORDER_MARK)
+    throw std::runtime_error("BSGS binary has foreign byte order");
+
+  word degree = reader.read();
+  word flags = reader.read();
+  word base_size = reader.read();
+  word sgs_size = reader.read();
+  word order_length = reader.read();
+
+  if (degree == 0u)
+    throw std::runtime_error("malformed BSGS binary data");
+
+  auto order_str(reader.read_string(order_length));
+
+  // base and strong generators
+  BSGS bsgs(degree);
+
+  bsgs._base = reader.read(base_size);
+
+  for (unsigned bp : bsgs._base) {
+    if (bp >= degree)
+      throw std::runtime_error("malformed BSGS binary data");
+  }
+
+  for (word i = 0u; i < sgs_size; ++i)
+    bsgs._strong_generators.insert(reader.read_perm(degree));
+
+  bsgs._is_symmetric = flags & BINARY_FLAG_SYMMETRIC;
+  bsgs._is_alternating = flags & BINARY_FLAG_ALTERNATING;
+
+  // schreier structures
+  auto options(BSGSOptions::fill_defaults(options_));
+
+  bsgs.transversals_init(&options);
+
+  order_type order = 1;
+
+  for (word i = 0u; i < base_size; ++i) {
+    PermSet labels;
+
+    word num_labels = reader.read();
+    for (word j = 0u; j < num_labels; ++j)
+      labels.insert(reader.read_perm(degree));
+
+    word orbit_size = reader.read();
+
+    auto nodes(reader.read(orbit_size));
+    auto destinations(reader.read(orbit_size));
+    auto edge_labels(reader.read(orbit_size));
+
+    if (orbit_size == 0u || nodes[0] != bsgs.base_point(i))
+      throw std::runtime_error("malformed BSGS binary data");
+
+    auto ss(bsgs._transversals->make_schreier_structure(
+      bsgs.base_point(i), degree, labels));
+
+    for (word j = 1u; j < orbit_size; ++j) {
+      if (nodes[j] >= degree ||
+          !ss->contains(destinations[j]) ||
+          edge_labels[j] >= num_labels) {
+        throw std::runtime_error("malformed BSGS binary data");
+      }
+
+      ss->create_edge(nodes[j], destinations[j], edge_labels[j]);
+    }
+
+    bsgs._transversals->restore_schreier_structure(i, ss);
+
+    order *= orbit_size;
+  }
+
+  if (!reader.done())
+    throw std::runtime_error("trailing BSGS binary data");
+
+  if (order.str() != order_str)
+    throw std::runtime_error("BSGS binary order mismatch");
+
+  return bsgs;
+}
+
+BSGS BSGS::from_binary_file(std::string const &binary_file,
+                            BSGSOptions const *options)
+{
+  return from_binary(util::read_file(binary_file), options);
+}
+
+std::string BSGS::to_binary() const
+{
+  BinaryWriter writer;
+
+  // header
+  writer.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  writer.write(BINARY_VERSION);
+  writer.write(BINARY_BYTE_ORDER_MARK);
+  writer.write(_degree);
+
+  word flags = 0u;
+  if (_is_symmetric)
+    flags |= BINARY_FLAG_SYMMETRIC;
+  if (_is_alternating)
+    flags |= BINARY_FLAG_ALTERNATING;
+
+  writer.write(flags);
+  writer.write(base_size());
+  writer.write(_strong_generators.size());
+
+  auto order_str(order().str());
+  writer.write(order_str.size());
+  writer.write(order_str.data(), order_str.size());
+
+  // base and strong generators
+  for (unsigned bp : _base)
+    writer.write(bp);
+
+  for (Perm const &sg : _strong_generators)
+    writer.write(sg);
+
+  // schreier structures
+  for (unsigned i = 0u; i < base_size(); ++i) {
+    auto labels(schreier_structure(i)->labels());
+
+    writer.write(labels.size());
+    for (Perm const &label : labels)
+      writer.write(label);
+
+    // recreate edges in an order in which every destination is known
+    std::vector<unsigned> nodes{base_point(i)};
+    std::vector<unsigned> destinations{base_point(i)};
+    std::vector<unsigned> edge_labels{NO_EDGE};
+
+    std::vector<bool> done(_degree, false);
+    done[base_point(i)] = true;
+
+    for (unsigned j = 0u; j < nodes.size(); ++j) {
+      unsigned x = nodes[j];
+
+      for (unsigned k = 0u; k < labels.size(); ++k) {
+        unsigned y = labels[k][x];
+
+        if (!done[y]) {
+          done[y] = true;
+
+          nodes.push_back(y);
+          destinations.push_back(x);
+          edge_labels.push_back(k);
+        }
+      }
+    }
+
+    writer.write(nodes.size());
+
+    for (unsigned x : nodes)
+      writer.write(x);
+
+    for (unsigned x : destinations)
+      writer.write(x);
+
+    for (unsigned x : edge_labels)
+      writer.write(x);
+  }
+
+  return writer.str();
+}
+
+void BSGS::to_binary_file(std::string const &binary_file) const
+{
+  std::ofstream stream(binary_file, std::ios::binary | std::ios::trunc);
+
+  if (!stream)
+    throw std::runtime_error("failed to open file");
+
+  auto binary(to_binary());
+  stream.write(binary.data(), binary.size());
+
+  if (!stream)
+    throw std::runtime_error("failed to write file");
+}
+
+} // namespace internal
+
+} // namespace mpsym
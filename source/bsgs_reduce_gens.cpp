@@ -7,6 +7,7 @@
 #include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
+#include "timeout.hpp"
 
 namespace mpsym
 {
@@ -14,10 +15,12 @@ namespace mpsym
 namespace internal
 {
 
-void BSGS::reduce_gens()
+void BSGS::reduce_gens(timeout::flag aborted)
 {
   DBG(DEBUG) << "Removing redundant strong generators";
 
+  timeout::Poll poll(aborted);
+
   std::unordered_set<Perm> strong_generator_set(_strong_generators.begin(),
                                                 _strong_generators.end());
 
@@ -44,6 +47,8 @@ void BSGS::reduce_gens()
 
     auto it(stabilizer_intersection.begin());
     while (it != stabilizer_intersection.end()) {
+      poll("reduce_gens");
+
       DBG(TRACE) << "Considering " << *it;
 
 #ifndef NDEBUG
@@ -6,10 +6,12 @@
 
 #include "bsgs.hpp"
 #include "dbg.hpp"
+#include "instrument.hpp"
 #include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
 #include "pr_randomizer.hpp"
+#include "progress.hpp"
 #include "schreier_generator_queue.hpp"
 #include "schreier_structure.hpp"
 #include "timeout.hpp"
@@ -42,18 +44,23 @@ void BSGS::schreier_sims(PermSet const &generators,
 
 void BSGS::schreier_sims(std::vector<PermSet> &strong_generators,
                          std::vector<Orbit> &fundamental_orbits,
-                         BSGSOptions const *,
+                         BSGSOptions const *options,
                          timeout::flag aborted)
 {
   std::vector<SchreierGeneratorQueue> schreier_generator_queues(base_size());
 
   DBG(TRACE) << "Iterating over Schreier Generators";
 
+  timeout::Poll poll(aborted);
+
+  progress::Reporter progress(options->progress_callback,
+                              progress::Phase::SCHREIER_SIMS,
+                              options->progress_interval);
+
   // main loop
   unsigned i = base_size();
   while (i >= 1u) {
-    if (timeout::is_set(aborted))
-      throw timeout::AbortedError("schreier_sims");
+    timeout::check(aborted, "schreier_sims");
 
     DBG(TRACE) << "i = " << i;
 top:
@@ -62,6 +69,16 @@ top:
                                             schreier_structure(i - 1));
 
     for (Perm const &schreier_generator : schreier_generator_queues[i - 1]) {
+      poll("schreier_sims");
+
+      INSTRUMENT_COUNT(SCHREIER_GENERATOR);
+
+      progress.state.base_size = base_size();
+      progress.state.level = i;
+      progress.state.schreier_generators = progress.state.processed + 1ULL;
+      progress.state.remaining = static_cast<double>(i - 1u);
+      progress.tick();
+
       if (schreier_generator.id())
         continue;
 
@@ -135,6 +152,10 @@ top:
     --i;
   }
 
+  progress.state.base_size = base_size();
+  progress.state.level = 0u;
+  progress.finish();
+
   schreier_sims_finish();
 }
 
@@ -203,10 +224,21 @@ void BSGS::schreier_sims_random(std::vector<PermSet> &strong_generators,
   // random group element generator
   PrRandomizer pr(_strong_generators);
 
+  timeout::Poll poll(aborted);
+
+  progress::Reporter progress(options->progress_callback,
+                              progress::Phase::SCHREIER_SIMS_RANDOM,
+                              options->progress_interval);
+
   unsigned c = 0u;
   while (c < options->schreier_sims_random_w) {
-    if (timeout::is_set(aborted))
-      throw timeout::AbortedError("schreier_sims_random");
+    poll("schreier_sims_random");
+
+    progress.state.base_size = base_size();
+    progress.state.elements = progress.state.processed + 1ULL;
+    progress.state.remaining =
+      static_cast<double>(options->schreier_sims_random_w - c);
+    progress.tick();
 
     // generate random group element
     Perm rand_perm = pr.next();
@@ -260,6 +292,9 @@ void BSGS::schreier_sims_random(std::vector<PermSet> &strong_generators,
       ++c;
     }
   }
+
+  progress.state.base_size = base_size();
+  progress.finish();
 }
 
 void BSGS::schreier_sims_init(PermSet const &generators,
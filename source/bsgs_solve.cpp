@@ -9,6 +9,7 @@
 #include "perm.hpp"
 #include "perm_set.hpp"
 #include "schreier_structure.hpp"
+#include "timeout.hpp"
 
 namespace mpsym
 {
@@ -16,7 +17,7 @@ namespace mpsym
 namespace internal
 {
 
-void BSGS::solve(PermSet const &generators)
+void BSGS::solve(PermSet const &generators, timeout::flag aborted)
 {
   DBG(DEBUG) << "Attempting to solve BSGS";
 
@@ -35,6 +36,8 @@ void BSGS::solve(PermSet const &generators)
 
       bool success = false;
       for (unsigned i = 0u; i < iterations; ++i) {
+        timeout::check(aborted, "solve");
+
         DBG(TRACE) << "Iteration " << i;
 
         std::pair<Perm, Perm> conjugates;
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bsgs.hpp"
+#include "perm.hpp"
+#include "perm_set.hpp"
+#include "schreier_structure.hpp"
+
+namespace
+{
+
+// upper bound on the number of entries in all dense transversal tables
+constexpr unsigned long STRIP_TABLES_MAX_ENTRIES = 1ul << 24;
+
+// minimum number of permutations stripped by each thread
+constexpr unsigned STRIP_BATCH_MIN_PER_THREAD = 256u;
+
+} // anonymous namespace
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+std::vector<bool> BSGS::strips_completely(PermSet const &perms,
+                                          unsigned num_threads) const
+{
+  if (perms.empty())
+    return {};
+
+  perms.assert_degree(_degree);
+
+  auto tables(strip_tables());
+
+  if (num_threads == 0u)
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  num_threads = std::min(num_threads,
+                         std::max(perms.size() / STRIP_BATCH_MIN_PER_THREAD, 1u));
+
+  std::vector<char> results(perms.size());
+
+  if (num_threads == 1u) {
+    strips_completely_batch(*tables, perms, 0u, perms.size(), results);
+
+  } else {
+    unsigned chunk = (perms.size() + num_threads - 1u) / num_threads;
+
+    std::vector<std::thread> threads;
+
+    for (unsigned first = 0u; first < perms.size(); first += chunk) {
+      unsigned last = std::min(first + chunk, perms.size());
+
+      threads.emplace_back([&, first, last]{
+        strips_completely_batch(*tables, perms, first, last, results);
+      });
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  return std::vector<bool>(results.begin(), results.end());
+}
+
+std::shared_ptr<BSGS::StripTables const> BSGS::strip_tables() const
+{
+  // concurrent callers may both build the tables, only one of them is kept
+  auto tables(std::atomic_load(&_strip_tables));
+
+  if (!tables) {
+    tables = std::make_shared<StripTables const>(strip_tables_build());
+    std::atomic_store(&_strip_tables, tables);
+  }
+
+  return tables;
+}
+
+BSGS::StripTables BSGS::strip_tables_build() const
+{
+  StripTables tables;
+
+  tables.orbit_indices.resize(base_size());
+  tables.inverse_transversals.resize(base_size());
+
+  unsigned long entries = 0u;
+
+  for (unsigned i = 0u; i < base_size(); ++i) {
+    auto nodes(schreier_structure(i)->nodes());
+
+    auto level_entries(static_cast<unsigned long>(nodes.size()) * _degree);
+
+    // levels exceeding the remaining table budget are stripped via their
+    // schreier structure, later (usually smaller) levels may still fit
+    if (level_entries > STRIP_TABLES_MAX_ENTRIES - entries)
+      continue;
+
+    entries += level_entries;
+
+    auto &orbit_indices(tables.orbit_indices[i]);
+    auto &inverse_transversals(tables.inverse_transversals[i]);
+
+    orbit_indices.resize(_degree, -1);
+    inverse_transversals.resize(nodes.size() * _degree);
+
+    for (unsigned j = 0u; j < nodes.size(); ++j) {
+      orbit_indices[nodes[j]] = static_cast<int>(j);
+
+      auto transv(schreier_structure(i)->transversal(nodes[j]));
+
+      unsigned *inverse_transv = &inverse_transversals[j * _degree];
+      for (unsigned x = 0u; x < _degree; ++x)
+        inverse_transv[transv[x]] = x;
+    }
+  }
+
+  return tables;
+}
+
+void BSGS::strips_completely_batch(StripTables const &tables,
+                                   PermSet const &perms,
+                                   unsigned first,
+                                   unsigned last,
+                                   std::vector<char> &results) const
+{
+  // permutation images stored contiguously, one row per permutation
+  std::vector<unsigned> images((last - first) * _degree);
+
+  std::vector<unsigned> active(last - first);
+
+  for (unsigned k = 0u; k < last - first; ++k) {
+    auto const &perm(perms[first + k]);
+
+    unsigned *row = &images[k * _degree];
+    for (unsigned x = 0u; x < _degree; ++x)
+      row[x] = perm[x];
+
+    active[k] = k;
+    results[first + k] = 0;
+  }
+
+  std::vector<unsigned> active_next;
+  active_next.reserve(active.size());
+
+  for (unsigned i = 0u; i < base_size() && !active.empty(); ++i) {
+    unsigned bp = base_point(i);
+
+    auto const &orbit_indices(tables.orbit_indices[i]);
+    auto const &inverse_transversals(tables.inverse_transversals[i]);
+
+    bool dense = !orbit_indices.empty();
+
+    active_next.clear();
+
+    for (unsigned k : active) {
+      unsigned *row = &images[k * _degree];
+      unsigned beta = row[bp];
+
+      if (dense) {
+        int j = orbit_indices[beta];
+        if (j == -1)
+          continue;
+
+        unsigned const *inverse_transv = &inverse_transversals[j * _degree];
+        for (unsigned x = 0u; x < _degree; ++x)
+          row[x] = inverse_transv[row[x]];
+
+      } else {
+        auto ss(schreier_structure(i));
+        if (!ss->contains(beta))
+          continue;
+
+        auto inverse_transv(~ss->transversal(beta));
+        for (unsigned x = 0u; x < _degree; ++x)
+          row[x] = inverse_transv[row[x]];
+      }
+
+      active_next.push_back(k);
+    }
+
+    active.swap(active_next);
+  }
+
+  for (unsigned k : active) {
+    unsigned const *row = &images[k * _degree];
+
+    bool id = true;
+    for (unsigned x = 0u; x < _degree; ++x) {
+      if (row[x] != x) {
+        id = false;
+        break;
+      }
+    }
+
+    results[first + k] = id ? 1 : 0;
+  }
+}
+
+} // namespace internal
+
+} // namespace mpsym
@@ -1,7 +1,5 @@
 #include "dbg.hpp"
 
-#ifndef NDEBUG
-
 namespace mpsym
 {
 
@@ -12,6 +10,7 @@ namespace dbg
 {
 
 int Dbg::loglevel = WARN;
+unsigned Dbg::trace_sampling = 1u;
 std::ostream *Dbg::out = &std::cout;
 
 } // namespace dbg
@@ -19,5 +18,3 @@ std::ostream *Dbg::out = &std::cout;
 } // namespace internal
 
 } // namespace mpsym
-
-#endif
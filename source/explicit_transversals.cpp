@@ -1,6 +1,7 @@
 #include <ostream>
 #include <vector>
 
+#include "instrument.hpp"
 #include "perm.hpp"
 #include "explicit_transversals.hpp"
 
@@ -52,6 +53,8 @@ bool ExplicitTransversals::incoming(unsigned, Perm const &) const
 
 Perm ExplicitTransversals::transversal(unsigned origin) const
 {
+  INSTRUMENT_COUNT(TRANSVERSAL);
+
   auto it(_orbit.find(origin));
 
   return it->second;
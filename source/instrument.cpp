@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "instrument.hpp"
+
+namespace
+{
+
+using mpsym::internal::instrument::Counters;
+using mpsym::internal::instrument::NUM_BUCKETS;
+using mpsym::internal::instrument::NUM_PROBES;
+using mpsym::internal::instrument::ThreadCounters;
+
+// counters of all live threads and the accumulated counters of exited threads
+struct Registry
+{
+  std::mutex mtx;
+  std::vector<ThreadCounters *> threads;
+  Counters retired{};
+};
+
+Registry &registry()
+{
+  // never destroyed so that threads exiting after static destruction can
+  // still unregister
+  static Registry *reg = new Registry;
+  return *reg;
+}
+
+void accumulate(Counters &counters, ThreadCounters const &thread_counters)
+{
+  for (unsigned p = 0u; p < NUM_PROBES; ++p) {
+    counters.count[p] += thread_counters.count[p].load(std::memory_order_relaxed);
+    counters.total_ns[p] += thread_counters.total_ns[p].load(std::memory_order_relaxed);
+
+    for (unsigned b = 0u; b < NUM_BUCKETS; ++b) {
+      counters.histogram[p][b] +=
+        thread_counters.histogram[p][b].load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void clear(ThreadCounters &thread_counters)
+{
+  for (unsigned p = 0u; p < NUM_PROBES; ++p) {
+    thread_counters.count[p].store(0ULL, std::memory_order_relaxed);
+    thread_counters.total_ns[p].store(0ULL, std::memory_order_relaxed);
+
+    for (unsigned b = 0u; b < NUM_BUCKETS; ++b)
+      thread_counters.histogram[p][b].store(0ULL, std::memory_order_relaxed);
+  }
+}
+
+unsigned bucket(unsigned long long ns)
+{
+  unsigned b = 0u;
+  while (ns > 0ULL && b < NUM_BUCKETS - 1u) {
+    ns >>= 1;
+    ++b;
+  }
+
+  return b;
+}
+
+} // anonymous namespace
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+namespace instrument
+{
+
+std::atomic<bool> _enabled(false);
+
+char const *probe_name(Probe probe)
+{
+  switch (probe) {
+    case STRIP:
+      return "strip";
+    case SCHREIER_GENERATOR:
+      return "schreier_generator";
+    case BASE_EXTENSION:
+      return "base_extension";
+    case TRANSVERSAL:
+      return "transversal";
+    case REPR:
+      return "repr";
+    case ORBIT_EXPANSION:
+      return "orbit_expansion";
+    case NUM_PROBES:
+      break;
+  }
+
+  throw std::logic_error("unreachable");
+}
+
+void enable(bool enable)
+{ _enabled.store(enable); }
+
+void reset()
+{
+  auto &reg(registry());
+
+  std::lock_guard<std::mutex> lock(reg.mtx);
+
+  for (auto *thread_counters : reg.threads)
+    clear(*thread_counters);
+
+  reg.retired = Counters{};
+}
+
+Counters collect()
+{
+  auto &reg(registry());
+
+  std::lock_guard<std::mutex> lock(reg.mtx);
+
+  Counters counters(reg.retired);
+
+  for (auto const *thread_counters : reg.threads)
+    accumulate(counters, *thread_counters);
+
+  return counters;
+}
+
+void dump_text(std::ostream &os)
+{
+  auto counters(collect());
+
+  for (unsigned p = 0u; p < NUM_PROBES; ++p) {
+    os << "INSTRUMENT (" << probe_name(static_cast<Probe>(p)) << "): "
+       << counters.count[p] << " invocations";
+
+    if (counters.total_ns[p] > 0ULL) {
+      double total = static_cast<double>(counters.total_ns[p]);
+
+      os << std::setprecision(3)
+         << ", total: " << total / 1e6 << "ms"
+         << ", mean: " << total / static_cast<double>(counters.count[p]) << "ns";
+    }
+
+    os << "\n";
+  }
+}
+
+std::string dump_json()
+{
+  auto counters(collect());
+
+  std::stringstream ss;
+
+  ss << "{";
+
+  for (unsigned p = 0u; p < NUM_PROBES; ++p) {
+    if (p > 0u)
+      ss << ",";
+
+    ss << "\"" << probe_name(static_cast<Probe>(p)) << "\":{"
+       << "\"count\":" << counters.count[p] << ","
+       << "\"total_ns\":" << counters.total_ns[p] << ","
+       << "\"histogram\":[";
+
+    // trailing empty buckets are omitted
+    unsigned num_buckets = NUM_BUCKETS;
+    while (num_buckets > 0u && counters.histogram[p][num_buckets - 1u] == 0ULL)
+      --num_buckets;
+
+    for (unsigned b = 0u; b < num_buckets; ++b) {
+      if (b > 0u)
+        ss << ",";
+
+      ss << counters.histogram[p][b];
+    }
+
+    ss << "]}";
+  }
+
+  ss << "}";
+
+  return ss.str();
+}
+
+ThreadCounters::ThreadCounters()
+{
+  clear(*this);
+
+  auto &reg(registry());
+
+  std::lock_guard<std::mutex> lock(reg.mtx);
+
+  reg.threads.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters()
+{
+  auto &reg(registry());
+
+  std::lock_guard<std::mutex> lock(reg.mtx);
+
+  accumulate(reg.retired, *this);
+
+  reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), this));
+}
+
+ThreadCounters &_thread_counters()
+{
+  static thread_local ThreadCounters thread_counters;
+
+  return thread_counters;
+}
+
+void record(Probe probe, unsigned long long ns)
+{
+  auto &thread_counters(_thread_counters());
+
+  _inc(thread_counters.count[probe]);
+  _inc(thread_counters.total_ns[probe], ns);
+  _inc(thread_counters.histogram[probe][bucket(ns)]);
+}
+
+} // namespace instrument
+
+} // namespace internal
+
+} // namespace mpsym
@@ -1,9 +1,11 @@
 #include <cassert>
-#include <map>
 #include <numeric>
+#include <ostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 extern "C" {
@@ -44,6 +46,47 @@ void _save_gens(int, int *perm, int *, int, int, int)
   _gens.emplace(tmp);
 }
 
+void _dump_certificate_header(std::ostream &os,
+                              int n,
+                              int n_reduced,
+                              bool directed,
+                              std::vector<std::vector<int>> const &ptn)
+{
+  os << n << ";" << n_reduced << ";" << directed << ";";
+
+  for (auto const &p : ptn) {
+    if (!p.empty())
+      os << p.size() << ",";
+  }
+
+  os << ";";
+}
+
+std::string _certificate(int n,
+                         int n_reduced,
+                         bool directed,
+                         std::vector<std::vector<int>> const &ptn,
+                         sparsegraph *cg)
+{
+  std::stringstream ss;
+
+  _dump_certificate_header(ss, n, n_reduced, directed, ptn);
+
+  // adjacency lists of the canonical graph, sorted
+  sortlists_sg(cg);
+
+  for (int v = 0; v < cg->nv; ++v) {
+    ss << v << ":";
+
+    for (int i = 0; i < cg->d[v]; ++i)
+      ss << cg->e[cg->v[v] + i] << ",";
+
+    ss << ";";
+  }
+
+  return ss.str();
+}
+
 } // anonymous namespace
 
 namespace mpsym
@@ -52,10 +95,11 @@ namespace mpsym
 namespace internal
 {
 
-NautyGraph::NautyGraph(int n, int n_reduced, bool directed)
+NautyGraph::NautyGraph(CSRGraph graph, bool directed, int n_reduced)
 : _directed(directed),
-  _n(n),
-  _n_reduced(n_reduced)
+  _n(graph.num_vertices()),
+  _n_reduced(n_reduced > 0 ? n_reduced : graph.num_vertices()),
+  _graph(std::move(graph))
 {
 #ifndef NDEBUG
   nauty_check(WORDSIZE, SETWORDSNEEDED(_n), _n, NAUTYVERSIONID);
@@ -84,11 +128,13 @@ std::string NautyGraph::to_gap() const
   ss << "ReduceGroup(GraphAutoms([";
 
   // edges
-  for (auto const &edge : _edges) {
-    int source = edge.first + 1;
-    int target = edge.second + 1;
+  for (int source = 0; source < _n; ++source) {
+    for (auto it = _graph.neighbours_begin(source);
+         it != _graph.neighbours_end(source);
+         ++it) {
 
-    ss << "[" << source << "," << target << "],";
+      ss << "[" << source + 1 << "," << *it + 1 << "],";
+    }
   }
 
   ss << "],";
@@ -111,26 +157,6 @@ std::string NautyGraph::to_gap() const
   return ss.str();
 }
 
-void NautyGraph::add_edge(int from, int to)
-{
-  assert(from < _n);
-  assert(to < _n);
-
-  _edges.emplace_back(from, to);
-
-  if (!_directed)
-    _edges.emplace_back(to, from);
-}
-
-void NautyGraph::add_edges(std::map<int, std::vector<int>> const &adj)
-{
-  for (auto const &p : adj) {
-    int from = p.first;
-    for (int to : p.second)
-      add_edge(from, to);
-  }
-}
-
 void NautyGraph::set_partition(std::vector<std::vector<int>> const &ptn)
 {
   _ptn_expl = ptn;
@@ -145,44 +171,49 @@ void NautyGraph::set_partition(std::vector<std::vector<int>> const &ptn)
   }
 }
 
-PermSet NautyGraph::automorphism_generators()
+PermSet NautyGraph::automorphism_generators(std::string *certificate,
+                                            std::vector<int> *canonical_labeling)
 {
-  if (_edges.empty())
-    return {};
-
-  // construct (sparse) nauty graph
-  sparsegraph sg;
+  if (_graph.num_arcs() == 0u) {
+    // the canonical labeling is given by the partition alone
+    if (certificate) {
+      std::stringstream ss;
+      _dump_certificate_header(ss, _n, _n_reduced, _directed, _ptn_expl);
 
-  SG_INIT(sg);
+      *certificate = ss.str();
+    }
 
-  int nde = static_cast<int>(_edges.size());
+    if (canonical_labeling)
+      canonical_labeling->assign(_lab, _lab + _n);
 
-  SG_ALLOC(sg, _n, nde, "SG_ALLOC");
+    return {};
+  }
 
-  sg.nv = _n;
-  sg.nde = nde;
+  // construct (sparse) nauty graph, nauty uses the same layout so it can
+  // borrow the CSR arrays as they are (nauty does not modify its input graph)
+  static_assert(std::is_same<std::remove_pointer<decltype(sparsegraph::v)>::type,
+                             std::size_t>::value,
+                "nauty edge offsets are of type std::size_t");
 
-  std::vector<std::vector<int>> out_edges(_n);
+  static_assert(std::is_same<std::remove_pointer<decltype(sparsegraph::d)>::type,
+                             int>::value,
+                "nauty vertex degrees are of type int");
 
-  for (int v = 0; v < _n; ++v)
-    sg.d[v] = 0;
+  sparsegraph sg;
 
-  for (auto const &edge : _edges) {
-    int source = edge.first;
-    int target = edge.second;
+  SG_INIT(sg);
 
-    ++sg.d[source];
+  sg.nv = _n;
+  sg.nde = _graph.num_arcs();
 
-    out_edges[source].push_back(target);
-  }
+  sg.v = const_cast<std::size_t *>(_graph.offsets().data());
+  sg.vlen = static_cast<std::size_t>(_n);
 
-  int e_offs = 0u;
-  for (int v = 0; v < _n; ++v) {
-    sg.v[v] = e_offs;
+  sg.d = const_cast<int *>(_graph.degrees().data());
+  sg.dlen = static_cast<std::size_t>(_n);
 
-    for (int target : out_edges[v])
-      sg.e[e_offs++] = target;
-  }
+  sg.e = const_cast<int *>(_graph.targets().data());
+  sg.elen = _graph.num_arcs();
 
   // set nauty options
   static DEFAULTOPTIONS_SPARSEDIGRAPH(nauty_options_directed);
@@ -194,15 +225,31 @@ PermSet NautyGraph::automorphism_generators()
   nauty_options.defaultptn = _ptn_expl.empty() ? TRUE : FALSE;
   nauty_options.userautomproc = _save_gens;
 
+  bool canonize = certificate || canonical_labeling;
+
+  nauty_options.getcanon = canonize ? TRUE : FALSE;
+
   // call nauty
   _gens.clear();
   _gen_degree = _n_reduced;
 
+  sparsegraph cg;
+
+  SG_INIT(cg);
+
   statsblk stats;
-  sparsenauty(&sg, _lab, _ptn, _orbits, &nauty_options, &stats, nullptr);
+  sparsenauty(&sg, _lab, _ptn, _orbits, &nauty_options, &stats,
+              canonize ? &cg : nullptr);
+
+  if (certificate)
+    *certificate = _certificate(_n, _n_reduced, _directed, _ptn_expl, &cg);
+
+  // after canonization, lab maps canonical to original vertex labels
+  if (canonical_labeling)
+    canonical_labeling->assign(_lab, _lab + _n);
 
-  // free memory
-  SG_FREE(sg);
+  // free memory (sg only borrows the CSR arrays)
+  SG_FREE(cg);
   nausparse_freedyn();
 
   return _gens;
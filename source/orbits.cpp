@@ -1,14 +1,24 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
-#include <unordered_set>
+#include <numeric>
+#include <thread>
 #include <vector>
 
+#include "instrument.hpp"
 #include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
 #include "schreier_structure.hpp"
 
+namespace
+{
+
+// minimum number of generator images merged by each thread
+constexpr unsigned long ORBIT_PARTITION_MIN_WORK_PER_THREAD = 1ul << 18;
+
+} // anonymous namespace
+
 namespace mpsym
 {
 
@@ -28,7 +38,9 @@ Orbit Orbit::generate(unsigned x,
 
   generators.assert_inverses();
 
-  orbit.extend(generators, {x}, {x}, ss);
+  orbit.reserve_members(generators.degree());
+
+  orbit.extend(generators, {x}, ss);
 
   return orbit;
 }
@@ -38,10 +50,25 @@ bool Orbit::operator==(Orbit const &other) const
   if (size() != other.size())
     return false;
 
-  std::set<unsigned> this_set(begin(), end());
-  std::set<unsigned> other_set(begin(), end());
+  if (!_indexed || !other._indexed) {
+    std::vector<unsigned> lhs(_elements), rhs(other._elements);
+
+    std::sort(lhs.begin(), lhs.end());
+    std::sort(rhs.begin(), rhs.end());
 
-  return this_set == other_set;
+    return lhs == rhs;
+  }
+
+  auto const &shorter(_members.size() < other._members.size() ? _members
+                                                               : other._members);
+  auto const &longer(_members.size() < other._members.size() ? other._members
+                                                              : _members);
+
+  if (!std::equal(shorter.begin(), shorter.end(), longer.begin()))
+    return false;
+
+  return std::all_of(longer.begin() + shorter.size(), longer.end(),
+                     [](member_word w){ return w == 0u; });
 }
 
 bool Orbit::generated_by(unsigned x, PermSet const &generators) const
@@ -51,15 +78,14 @@ bool Orbit::generated_by(unsigned x, PermSet const &generators) const
 
   assert(x < generators.degree());
 
-  // this orbit
-  std::unordered_set<unsigned> this_orbit;
-  this_orbit.insert(begin(), end());
-
-  if (this_orbit.find(x) == this_orbit.end())
+  if (!contains(x))
     return false;
 
   // orbit of x
-  std::unordered_set<unsigned> x_orbit{x};
+  std::vector<char> x_orbit(generators.degree(), 0);
+  x_orbit[x] = 1;
+
+  std::vector<unsigned>::size_type x_orbit_size = 1u;
 
   // enumerate orbit of x
   auto generators_with_inverses(generators.with_inverses());
@@ -74,14 +100,14 @@ bool Orbit::generated_by(unsigned x, PermSet const &generators) const
       unsigned y_prime = gen[y];
 
       // check if the orbit of x contains an element not in this orbit
-      if (this_orbit.find(y_prime) == this_orbit.end())
+      if (!contains(y_prime))
         return false;
 
-      if (x_orbit.find(y_prime) == x_orbit.end()) {
-        x_orbit.insert(y_prime);
+      if (!x_orbit[y_prime]) {
+        x_orbit[y_prime] = 1;
 
         // check if this orbit is a subset of the orbit of x
-        if (x_orbit.size() > this_orbit.size())
+        if (++x_orbit_size > size())
           return false;
 
         stack.push_back(y_prime);
@@ -90,7 +116,7 @@ bool Orbit::generated_by(unsigned x, PermSet const &generators) const
   }
 
   // check if the orbit of x is a subset of this orbit
-  if (x_orbit.size() < this_orbit.size())
+  if (x_orbit_size < size())
     return false;
 
   // the orbits match
@@ -120,15 +146,17 @@ void Orbit::update(PermSet const &generators_old,
       ss->add_label(gen_new);
   }
 
+  index();
+  reserve_members(generators.degree());
+
   std::vector<unsigned> stack;
-  std::unordered_set<unsigned> done(begin(), end());
 
   for (unsigned i = 0u; i < generators_new.size(); ++i) {
     for (unsigned x : *this) {
       unsigned y = generators_new[i][x];
 
-      if (done.find(y) == done.end()) {
-        done.insert(y);
+      if (!contains(y)) {
+        add_member(y);
         stack.push_back(y);
 
         if (ss)
@@ -139,14 +167,16 @@ void Orbit::update(PermSet const &generators_old,
 
   _elements.insert(end(), stack.begin(), stack.end());
 
-  extend(generators, stack, done, ss);
+  extend(generators, stack, ss);
 }
 
 void Orbit::extend(PermSet const &generators,
                    std::vector<unsigned> stack,
-                   std::unordered_set<unsigned> done,
                    std::shared_ptr<SchreierStructure> ss)
 {
+  INSTRUMENT_SCOPE(ORBIT_EXPANSION);
+
+  // points already contained in the orbit are marked in its member bitset
   while (!stack.empty()) {
     unsigned x = stack.back();
     stack.pop_back();
@@ -156,8 +186,8 @@ void Orbit::extend(PermSet const &generators,
     for (auto i = 0u; i < generators.size(); ++i) {
       unsigned y = generators[i][x];
 
-      if (done.find(y) == done.end()) {
-        done.insert(y);
+      if (!contains(y)) {
+        add_member(y);
         stack.push_back(y);
 
         _elements.push_back(y);
@@ -185,6 +215,9 @@ OrbitPartition::OrbitPartition(unsigned degree,
   }
 #endif
 
+  for (auto &part : _partitions)
+    part.unindex();
+
   update_partition_indices();
 }
 
@@ -209,27 +242,108 @@ OrbitPartition::OrbitPartition(unsigned degree, PermSet const &generators)
 
   assert(generators.degree() == degree);
 
-  std::vector<int> processed(generators.degree(), 0);
-  unsigned num_processed = 0u;
+  // merge the cycles of all generators in a union-find structure, for many
+  // generators this is done in parallel and the results are merged afterwards
+  auto &classes(_classes);
+  classes = union_find_init(degree);
 
-  unsigned x = 0u;
+  unsigned long work = static_cast<unsigned long>(degree) * generators.size();
 
-  for (;;) {
-    auto orbit(Orbit::generate(x, generators.with_inverses()));
+  unsigned num_threads = std::min(
+    std::thread::hardware_concurrency(),
+    static_cast<unsigned>(work / ORBIT_PARTITION_MIN_WORK_PER_THREAD));
 
-    _partitions.push_back(orbit);
+  num_threads = std::min(num_threads, static_cast<unsigned>(generators.size()));
 
-    if ((num_processed += orbit.size()) == generators.degree())
-      break;
+  if (num_threads <= 1u) {
+    unsigned num_classes = degree;
+
+    // stop early once all points are in one orbit, e.g. for transitive groups
+    for (Perm const &gen : generators) {
+      num_classes -= union_find_merge(gen, classes);
+
+      if (num_classes == 1u)
+        break;
+    }
+
+  } else {
+    std::vector<std::vector<unsigned>> thread_classes(num_threads - 1u);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1u; t < num_threads; ++t) {
+      threads.emplace_back([&, t]{
+        auto &thread_class(thread_classes[t - 1u]);
+        thread_class = union_find_init(degree);
+
+        for (unsigned i = t; i < generators.size(); i += num_threads)
+          union_find_merge(generators[i], thread_class);
+      });
+    }
+
+    for (unsigned i = 0u; i < generators.size(); i += num_threads)
+      union_find_merge(generators[i], classes);
 
-    for (unsigned y : orbit)
-      processed[y] = 1;
+    for (auto &thread : threads)
+      thread.join();
 
-    while (processed[x])
-      ++x;
+    for (auto &thread_class : thread_classes) {
+      for (unsigned x = 0u; x < degree; ++x)
+        union_find_union(x, union_find_find(x, thread_class), classes);
+    }
   }
 
-  update_partition_indices();
+  union_find_apply(true);
+}
+
+void OrbitPartition::add_generator(Perm const &generator)
+{
+  assert(generator.degree() == _partition_indices.size());
+
+  union_find_sync();
+
+  // points not yet part of any partition are fixed points and thus singleton
+  // classes, moving them always merges classes
+  bool merged = false;
+
+  for (unsigned x = 0u; x < _partition_indices.size(); ++x) {
+    unsigned y = generator[x];
+
+    if (y == x || !union_find_union(x, y, _classes))
+      continue;
+
+    merged = true;
+
+    // included in some partition from now on, index fixed up below
+    if (_partition_indices[x] == -1)
+      _partition_indices[x] = 0;
+    if (_partition_indices[y] == -1)
+      _partition_indices[y] = 0;
+  }
+
+  if (merged)
+    union_find_apply(false);
+}
+
+void OrbitPartition::merge_partitions(
+  std::vector<std::pair<unsigned, unsigned>> const &merges)
+{
+  union_find_sync();
+
+  bool merged = false;
+
+  for (auto const &merge : merges) {
+    assert(!_partitions[merge.first].empty());
+    assert(!_partitions[merge.second].empty());
+
+    unsigned x = *_partitions[merge.first].begin();
+    unsigned y = *_partitions[merge.second].begin();
+
+    if (union_find_union(x, y, _classes))
+      merged = true;
+  }
+
+  if (merged)
+    union_find_apply(false);
 }
 
 std::vector<OrbitPartition> OrbitPartition::split(
@@ -274,6 +388,8 @@ void OrbitPartition::remove_from_partition(unsigned x)
     std::find(_partitions[i].begin(), _partitions[i].end(), x));
 
   _partition_indices[x] = -1;
+
+  _classes.clear();
 }
 
 void OrbitPartition::change_partition(unsigned x, int i)
@@ -287,6 +403,8 @@ void OrbitPartition::change_partition(unsigned x, int i)
 
   _partition_indices[x] = i;
 
+  _classes.clear();
+
   for (auto p_it = _partitions.begin(); p_it != _partitions.end(); ++p_it) {
     auto e_it = std::find(p_it->begin(), p_it->end(), x);
 
@@ -303,11 +421,111 @@ void OrbitPartition::change_partition(unsigned x, int i)
   add_to_partition(x, i);
 }
 
+std::vector<unsigned> OrbitPartition::union_find_init(unsigned degree)
+{
+  std::vector<unsigned> classes(degree);
+  std::iota(classes.begin(), classes.end(), 0u);
+
+  return classes;
+}
+
+unsigned OrbitPartition::union_find_find(unsigned x,
+                                         std::vector<unsigned> &classes)
+{
+  while (classes[x] != x) {
+    classes[x] = classes[classes[x]];
+    x = classes[x];
+  }
+
+  return x;
+}
+
+bool OrbitPartition::union_find_union(unsigned x,
+                                      unsigned y,
+                                      std::vector<unsigned> &classes)
+{
+  unsigned rx = union_find_find(x, classes);
+  unsigned ry = union_find_find(y, classes);
+
+  if (rx == ry)
+    return false;
+
+  // the smallest point of every class is its representative
+  if (rx < ry)
+    classes[ry] = rx;
+  else
+    classes[rx] = ry;
+
+  return true;
+}
+
+unsigned OrbitPartition::union_find_merge(Perm const &generator,
+                                          std::vector<unsigned> &classes)
+{
+  unsigned merges = 0u;
+
+  for (unsigned x = 0u; x < generator.degree(); ++x) {
+    if (generator[x] != x && union_find_union(x, generator[x], classes))
+      ++merges;
+  }
+
+  return merges;
+}
+
+void OrbitPartition::union_find_sync()
+{
+  if (!_classes.empty() || _partition_indices.empty())
+    return;
+
+  _classes = union_find_init(static_cast<unsigned>(_partition_indices.size()));
+
+  for (auto const &partition : _partitions) {
+    if (partition.empty())
+      continue;
+
+    unsigned first = *partition.begin();
+
+    for (unsigned x : partition)
+      union_find_union(first, x, _classes);
+  }
+}
+
+void OrbitPartition::union_find_apply(bool all_points)
+{
+  // partitions are ordered by their smallest element, points not contained in
+  // any partition are skipped unless 'all_points' is set
+  std::vector<int> class_indices(_classes.size(), -1);
+
+  _partitions.clear();
+
+  for (unsigned x = 0u; x < _classes.size(); ++x) {
+    if (!all_points && _partition_indices[x] == -1)
+      continue;
+
+    unsigned rep = union_find_find(x, _classes);
+
+    if (class_indices[rep] == -1) {
+      class_indices[rep] = static_cast<int>(_partitions.size());
+      _partitions.emplace_back();
+      _partitions.back().unindex();
+    }
+
+    _partition_indices[x] = class_indices[rep];
+    _partitions[class_indices[rep]].insert(x);
+  }
+}
+
 void OrbitPartition::add_to_partition(unsigned x, int i)
 {
-  if (i >= static_cast<int>(_partitions.size()) - 1)
+  if (i >= static_cast<int>(_partitions.size()) - 1) {
+    auto old_size = _partitions.size();
+
     _partitions.resize(i + 1);
 
+    for (auto j = old_size; j < _partitions.size(); ++j)
+      _partitions[j].unindex();
+  }
+
   _partitions[i].insert(x);
 }
 
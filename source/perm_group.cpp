@@ -1,15 +1,20 @@
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <limits>
 #include <memory>
 #include <ostream>
 #include <random>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include "block_system.hpp"
 #include "bsgs.hpp"
+#include "dump.hpp"
 #include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
@@ -49,6 +54,127 @@ bool PermGroup::operator!=(PermGroup const &rhs) const
   return !(*this == rhs);
 }
 
+std::string PermGroup::fingerprint() const
+{
+  // invariants which do not depend on the choice of generators, every point
+  // is labelled by the smallest point in its orbit
+  std::vector<unsigned> orbit_labels(degree());
+
+  if (is_trivial()) {
+    for (unsigned x = 0u; x < degree(); ++x)
+      orbit_labels[x] = x;
+
+  } else {
+    OrbitPartition orbits(degree(), generators());
+
+    for (auto const &orbit : orbits) {
+      unsigned label = *std::min_element(orbit.begin(), orbit.end());
+
+      for (unsigned x : orbit)
+        orbit_labels[x] = label;
+    }
+  }
+
+  std::stringstream ss;
+  ss << degree() << ";" << order() << ";" << DUMP(orbit_labels);
+
+  return ss.str();
+}
+
+std::vector<BlockSystem> PermGroup::block_systems(timeout::flag aborted) const
+{
+  auto block_systems(_block_systems_cache.load());
+
+  // concurrent callers may determine the block systems more than once but all
+  // of them end up with the ones published first
+  if (!block_systems) {
+    block_systems = _block_systems_cache.publish(
+      std::make_shared<std::vector<BlockSystem> const>(
+        BlockSystem::non_trivial(*this, false, aborted)));
+  }
+
+  return *block_systems;
+}
+
+std::size_t PermGroup::memory_usage() const
+{
+  std::size_t res = _bsgs.memory_usage();
+
+  auto block_systems(_block_systems_cache.load());
+
+  if (block_systems) {
+    res += util::container_memory_usage(
+      *block_systems,
+      [](BlockSystem const &bs){ return bs.memory_usage(); });
+  }
+
+  return res;
+}
+
+std::size_t PermGroup::memory_usage(PermGroup const &shared_with) const
+{
+  std::size_t res = _bsgs.memory_usage(shared_with._bsgs);
+
+  if (_block_systems_cache.shared_with(shared_with._block_systems_cache))
+    return res;
+
+  auto block_systems(_block_systems_cache.load());
+
+  if (block_systems) {
+    res += util::container_memory_usage(
+      *block_systems,
+      [](BlockSystem const &bs){ return bs.memory_usage(); });
+  }
+
+  return res;
+}
+
+PermGroup::BlockSystemsCache::block_systems_type
+PermGroup::BlockSystemsCache::load() const
+{
+  auto shared(std::atomic_load(&_shared));
+
+  return shared ? std::atomic_load(shared.get()) : block_systems_type();
+}
+
+PermGroup::BlockSystemsCache::block_systems_type
+PermGroup::BlockSystemsCache::publish(block_systems_type block_systems) const
+{
+  auto shared(this->shared());
+
+  block_systems_type published;
+  if (std::atomic_compare_exchange_strong(shared.get(),
+                                          &published,
+                                          block_systems)) {
+    return block_systems;
+  }
+
+  return published;
+}
+
+bool PermGroup::BlockSystemsCache::shared_with(
+  BlockSystemsCache const &other) const
+{
+  auto shared(std::atomic_load(&_shared));
+
+  return shared && shared == std::atomic_load(&other._shared);
+}
+
+std::shared_ptr<PermGroup::BlockSystemsCache::block_systems_type>
+PermGroup::BlockSystemsCache::shared() const
+{
+  auto shared(std::atomic_load(&_shared));
+
+  if (!shared) {
+    auto created(std::make_shared<block_systems_type>());
+
+    if (std::atomic_compare_exchange_strong(&_shared, &shared, created))
+      shared = created;
+  }
+
+  return shared;
+}
+
 PermGroup PermGroup::symmetric(unsigned degree)
 {
   // TODO: explicit BSGS
@@ -226,9 +352,21 @@ bool PermGroup::is_shifted_symmetric() const
 
 bool PermGroup::is_transitive() const
 {
-  auto orbit(Orbit::generate(0u, generators().with_inverses()));
+  if (is_trivial())
+    return degree() == 1u;
 
-  return orbit.size() == degree();
+  // coarsen the orbit partition one generator at a time and stop as soon as
+  // all points lie in a single orbit
+  OrbitPartition orbits(degree());
+
+  for (Perm const &gen : generators()) {
+    orbits.add_generator(gen);
+
+    if (orbits.num_partitions() == 1u && orbits[0].size() == degree())
+      return true;
+  }
+
+  return false;
 }
 
 bool PermGroup::contains_element(Perm const &perm) const
@@ -238,9 +376,15 @@ bool PermGroup::contains_element(Perm const &perm) const
   return _bsgs.strips_completely(perm);
 }
 
+std::vector<bool> PermGroup::contains_elements(PermSet const &perms,
+                                               unsigned num_threads) const
+{
+  return _bsgs.strips_completely(perms, num_threads);
+}
+
 Perm PermGroup::random_element() const
 {
-  static auto re(util::random_engine());
+  static thread_local auto re(util::random_engine());
 
   Perm result(degree());
   for (unsigned i = 0u; i < _bsgs.base_size(); ++i) {
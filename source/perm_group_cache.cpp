@@ -0,0 +1,224 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include <unistd.h>
+
+#include "bsgs.hpp"
+#include "dbg.hpp"
+#include "perm_group.hpp"
+#include "perm_group_cache.hpp"
+#include "util.hpp"
+
+namespace
+{
+
+char const DISK_CACHE_MAGIC[8] = {'M', 'P', 'S', 'Y', 'M', 'P', 'G', 'C'};
+
+std::atomic<unsigned> disk_cache_tmp_counter(0u);
+
+} // anonymous namespace
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+PermGroupCache &PermGroupCache::global()
+{
+  static PermGroupCache cache;
+  return cache;
+}
+
+PermGroupCache::group_ptr PermGroupCache::find(std::string const &key) const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto it(_groups_by_key.find(key));
+  if (it == _groups_by_key.end())
+    return nullptr;
+
+  return it->second;
+}
+
+PermGroupCache::group_ptr PermGroupCache::insert(std::string const &key,
+                                                 PermGroup const &pg)
+{
+  // fingerprints are only invariants, so equality is checked explicitly
+  auto fingerprint(pg.fingerprint());
+
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto it_key(_groups_by_key.find(key));
+  if (it_key != _groups_by_key.end())
+    return it_key->second;
+
+  group_ptr shared;
+
+  auto candidates(_groups_by_fingerprint.equal_range(fingerprint));
+  for (auto it = candidates.first; it != candidates.second; ++it) {
+    if (*it->second == pg) {
+      shared = it->second;
+      break;
+    }
+  }
+
+  if (!shared) {
+    shared = std::make_shared<PermGroup const>(pg);
+    _groups_by_fingerprint.emplace(fingerprint, shared);
+  }
+
+  _groups_by_key.emplace(key, shared);
+
+  return shared;
+}
+
+unsigned PermGroupCache::num_keys() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  return _groups_by_key.size();
+}
+
+unsigned PermGroupCache::num_groups() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  return _groups_by_fingerprint.size();
+}
+
+void PermGroupCache::clear()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  _groups_by_key.clear();
+  _groups_by_fingerprint.clear();
+}
+
+constexpr unsigned PermGroupDiskCache::VERSION;
+
+// cache entries consist of a header containing the full key, which guards
+// against hash collisions, followed by a binary BSGS
+
+boost::optional<BSGS> PermGroupDiskCache::load(std::string const &key,
+                                               BSGSOptions const *options) const
+{
+  std::ifstream stream(path(key), std::ios::binary);
+  if (!stream)
+    return boost::none;
+
+  std::string content((std::istreambuf_iterator<char>(stream)),
+                      std::istreambuf_iterator<char>());
+
+  std::size_t header_size = sizeof(DISK_CACHE_MAGIC) + 2u * sizeof(std::uint32_t);
+
+  if (content.size() < header_size ||
+      std::memcmp(content.data(), DISK_CACHE_MAGIC, sizeof(DISK_CACHE_MAGIC)) != 0) {
+    return boost::none;
+  }
+
+  std::uint32_t version, key_length;
+
+  std::memcpy(&version, content.data() + sizeof(DISK_CACHE_MAGIC),
+              sizeof(std::uint32_t));
+
+  std::memcpy(&key_length, content.data() + sizeof(DISK_CACHE_MAGIC)
+                                          + sizeof(std::uint32_t),
+              sizeof(std::uint32_t));
+
+  if (version != VERSION || content.size() - header_size < key_length)
+    return boost::none;
+
+  if (content.compare(header_size, key_length, key) != 0)
+    return boost::none;
+
+  try {
+    return BSGS::from_binary(content.data() + header_size + key_length,
+                             content.size() - header_size - key_length,
+                             options);
+  } catch (std::runtime_error const &) {
+    return boost::none;
+  }
+}
+
+bool PermGroupDiskCache::store(std::string const &key,
+                               BSGS const &bsgs,
+                               std::string *error) const
+{
+  auto target(path(key));
+
+  // write to a temporary file first so that readers never see partial entries
+  std::stringstream tmp;
+  tmp << target << ".tmp." << getpid() << "." << disk_cache_tmp_counter++;
+
+  auto tmp_path(tmp.str());
+
+  auto fail = [&](std::string const &msg){
+    DBG(WARN) << msg;
+
+    if (error)
+      *error = msg;
+
+    return false;
+  };
+
+  std::ofstream stream(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!stream)
+    return fail("failed to create group cache file " + tmp_path);
+
+  std::uint32_t version = VERSION;
+  std::uint32_t key_length = key.size();
+
+  stream.write(DISK_CACHE_MAGIC, sizeof(DISK_CACHE_MAGIC));
+  stream.write(reinterpret_cast<char const *>(&version), sizeof(version));
+  stream.write(reinterpret_cast<char const *>(&key_length), sizeof(key_length));
+  stream.write(key.data(), key.size());
+
+  auto binary(bsgs.to_binary());
+  stream.write(binary.data(), binary.size());
+
+  // closing flushes the remaining buffer which can fail as well
+  stream.close();
+
+  if (!stream) {
+    std::remove(tmp_path.c_str());
+
+    return fail("failed to write group cache file " + tmp_path);
+  }
+
+  if (std::rename(tmp_path.c_str(), target.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+
+    return fail("failed to move group cache file into place " + target);
+  }
+
+  return true;
+}
+
+std::string PermGroupDiskCache::path(std::string const &key) const
+{
+  std::stringstream ss;
+
+  ss << _dir << "/mpsym-v" << VERSION << "-"
+     << std::hex << std::setw(16) << std::setfill('0')
+     << util::container_hash(key.begin(), key.end())
+     << ".bsgs";
+
+  return ss.str();
+}
+
+} // namespace internal
+
+} // namespace mpsym
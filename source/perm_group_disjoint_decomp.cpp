@@ -1,16 +1,22 @@
 #include <algorithm>
 #include <cassert>
+#include <functional>
+#include <future>
 #include <iterator>
 #include <memory>
+#include <numeric>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "bsgs.hpp"
 #include "dbg.hpp"
 #include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
+#include "timeout.hpp"
 #include "timer.hpp"
 
 namespace mpsym
@@ -21,25 +27,37 @@ namespace internal
 
 std::vector<PermGroup> PermGroup::disjoint_decomposition(
   bool complete,
-  bool disjoint_orbit_optimization) const
+  bool disjoint_orbit_optimization,
+  BSGSOptions const *options,
+  timeout::flag aborted) const
 {
-  return complete ? disjoint_decomp_complete(disjoint_orbit_optimization)
-                  : disjoint_decomp_incomplete();
+  return complete ? disjoint_decomp_complete(disjoint_orbit_optimization,
+                                             options,
+                                             aborted)
+                  : disjoint_decomp_incomplete(options);
 }
 
 bool PermGroup::disjoint_decomp_orbits_dependent(
-  Orbit const &orbit1,
-  Orbit const &orbit2) const
+  OrbitPartition const &orbits,
+  unsigned i,
+  unsigned j,
+  timeout::Poll &poll) const
 {
   std::unordered_set<Perm> restricted_stabilizers, restricted_elements;
 
+  // orbits belonging to a partition have no membership bitset
+  auto in_orbit1 = [&](unsigned x)
+  { return orbits.partition_index(x) == static_cast<int>(i); };
+
   for (Perm const &perm : *this) {
-    Perm restricted_perm(perm.restricted(orbit1.begin(), orbit1.end()));
+    poll("disjoint_decomposition");
+
+    Perm restricted_perm(perm.restricted_if(in_orbit1));
 
     if (restricted_perm.id())
       continue;
 
-    if (perm.stabilizes(orbit2.begin(), orbit2.end()))
+    if (perm.stabilizes(orbits[j].begin(), orbits[j].end()))
       restricted_stabilizers.insert(restricted_perm);
 
     restricted_elements.insert(restricted_perm);
@@ -49,80 +67,77 @@ bool PermGroup::disjoint_decomp_orbits_dependent(
 }
 
 void PermGroup::disjoint_decomp_generate_dependency_classes(
-  OrbitPartition &orbits) const
+  OrbitPartition &orbits,
+  timeout::flag aborted) const
 {
-  unsigned num_dependency_classes = 0u;
+  timeout::Poll poll(aborted);
+
+  std::vector<bool> merged(orbits.num_partitions(), false);
+  std::vector<std::pair<unsigned, unsigned>> merges;
 
-  std::vector<int> processed(orbits.num_partitions(), 0);
   unsigned num_processed = 0u;
 
   for (unsigned i = 0u; i < orbits.num_partitions(); ++i) {
-    if (processed[i])
+    if (merged[i])
       continue;
 
     // determine which orbits to merge
-    std::unordered_set<unsigned> merge{i};
-
     for (unsigned j = i + 1u; j < orbits.num_partitions(); ++j) {
-      if (processed[j])
+      if (merged[j])
         continue;
 
-      if (disjoint_decomp_orbits_dependent(orbits[i], orbits[j])) {
-        merge.insert(j);
-
-        processed[j] = 1;
+      if (disjoint_decomp_orbits_dependent(orbits, i, j, poll)) {
+        merged[j] = true;
+        merges.emplace_back(i, j);
         ++num_processed;
       }
     }
 
-    // merge orbits
-    for (unsigned x = 0u; x < degree(); ++x) {
-      if (merge.find(orbits.partition_index(x)) != merge.end())
-        orbits.change_partition(x, num_dependency_classes);
-    }
-
-    ++num_dependency_classes;
-
     // check if we're done
-    processed[i] = 1;
-
     if (++num_processed == orbits.num_partitions())
       break;
   }
+
+  // merge orbits in a single pass
+  orbits.merge_partitions(merges);
 }
 
 bool PermGroup::disjoint_decomp_restricted_subgroups(
   OrbitPartition const &orbit_split,
   PermGroup const &perm_group,
+  BSGSOptions const *options,
   std::pair<PermGroup, PermGroup> &restricted_subgroups)
 {
-  auto split1(orbit_split[0]);
-  auto split2(orbit_split[1]);
+  auto in_split1 = [&](unsigned x){ return orbit_split.partition_index(x) == 0; };
+  auto in_split2 = [&](unsigned x){ return orbit_split.partition_index(x) == 1; };
 
   PermSet restricted_generators1;
   PermSet restricted_generators2;
 
   for (Perm const &gen : perm_group.generators()) {
-    Perm restricted_generator1(gen.restricted(split1.begin(), split1.end()));
-    Perm restricted_generator2(gen.restricted(split2.begin(), split2.end()));
+    restricted_generators1.insert(gen.restricted_if(in_split1));
+    restricted_generators2.insert(gen.restricted_if(in_split2));
+  }
 
-    if (!perm_group.contains_element(restricted_generator1) ||
-        !perm_group.contains_element(restricted_generator2)) {
+  // the group is the direct product of its restrictions iff these are
+  // contained in it
+  PermSet restricted_generators(restricted_generators1);
+  restricted_generators.insert(restricted_generators2.begin(),
+                               restricted_generators2.end());
 
+  for (bool member : perm_group.contains_elements(restricted_generators, 1u)) {
+    if (!member) {
       DBG(TRACE) << "Restricted groups are not a disjoint subgroup decomposition";
 
       return false;
     }
-
-    restricted_generators1.insert(restricted_generator1);
-    restricted_generators2.insert(restricted_generator2);
   }
 
-  restricted_subgroups.first = PermGroup(perm_group.degree(),
-                                         restricted_generators1);
+  restricted_subgroups.first = disjoint_decomp_restricted_subgroup(
+    orbit_split, 0, perm_group, restricted_generators1, options);
 
-  restricted_subgroups.second = PermGroup(perm_group.degree(),
-                                          restricted_generators2);
+  restricted_subgroups.second = disjoint_decomp_restricted_subgroup(
+    orbit_split, 1, perm_group, restricted_generators2, options);
 
   DBG(TRACE) << "Found disjoint subgroup decomposition:";
   DBG(TRACE) << restricted_subgroups.first;
@@ -131,6 +146,40 @@ bool PermGroup::disjoint_decomp_restricted_subgroups(
   return true;
 }
 
+PermGroup PermGroup::disjoint_decomp_restricted_subgroup(
+  OrbitPartition const &orbit_split,
+  int split,
+  PermGroup const &perm_group,
+  PermSet const &restricted_generators,
+  BSGSOptions const *options)
+{
+  // restricting a strong generating set of a direct product of groups with
+  // disjoint support yields strong generating sets of the factors relative to
+  // the restricted base, so no schreier sims run is necessary
+  BSGS::Base restricted_base;
+  for (unsigned bp : perm_group.bsgs().base()) {
+    if (orbit_split.partition_index(bp) == split)
+      restricted_base.push_back(bp);
+  }
+
+  PermSet restricted_strong_generators;
+  for (Perm const &gen : restricted_generators) {
+    if (!gen.id())
+      restricted_strong_generators.insert(gen);
+  }
+
+  if (restricted_strong_generators.empty())
+    return PermGroup(perm_group.degree());
+
+  restricted_strong_generators.insert_inverses();
+  restricted_strong_generators.make_unique();
+
+  return PermGroup(BSGS(perm_group.degree(),
+                        restricted_base,
+                        restricted_strong_generators,
+                        options));
+}
+
 std::vector<PermGroup> PermGroup::disjoint_decomp_join_results(
   std::vector<PermGroup> const &res1,
   std::vector<PermGroup> const &res2)
@@ -144,24 +193,28 @@ std::vector<PermGroup> PermGroup::disjoint_decomp_join_results(
 
 std::vector<PermGroup> PermGroup::disjoint_decomp_complete_recursive(
   OrbitPartition const &orbits,
-  PermGroup const &perm_group)
+  PermGroup const &perm_group,
+  BSGSOptions const *options,
+  timeout::flag aborted,
+  unsigned parallel_depth)
 {
   // iterate over all possible partitions of the set of all orbits into two sets
   assert(orbits.num_partitions() < 8 * sizeof(unsigned long long));
 
   for (auto part = 1ULL; !(part & (1ULL << (orbits.num_partitions() - 1u))); ++part) {
-    OrbitPartition orbit_split(perm_group.degree());
+    timeout::check(aborted, "disjoint_decomposition");
+
+    std::vector<int> split_indices(perm_group.degree(), -1);
 
     for (unsigned x = 0u; x < perm_group.degree(); ++x) {
-      if (orbits.partition_index(x) == -1)
-        continue;
+      int i = orbits.partition_index(x);
 
-      if ((1ULL << orbits.partition_index(x)) & part)
-        orbit_split.change_partition(x, 1);
-      else
-        orbit_split.change_partition(x, 0);
+      if (i != -1)
+        split_indices[x] = (1ULL << i) & part ? 1 : 0;
     }
 
+    OrbitPartition orbit_split(perm_group.degree(), split_indices);
+
     DBG(TRACE) << "Considering orbit split:";
     DBG(TRACE) << orbit_split;
 
@@ -169,7 +222,7 @@ std::vector<PermGroup> PermGroup::disjoint_decomp_complete_recursive(
     std::pair<PermGroup, PermGroup> restricted_subgroups;
 
     if (!disjoint_decomp_restricted_subgroups(
-          orbit_split, perm_group, restricted_subgroups))
+          orbit_split, perm_group, options, restricted_subgroups))
       continue;
 
     DBG(TRACE) << "Restricted groups are a disjoint subgroup decomposition";
@@ -181,11 +234,34 @@ std::vector<PermGroup> PermGroup::disjoint_decomp_complete_recursive(
     DBG(TRACE) << orbits_recurse[0];
     DBG(TRACE) << orbits_recurse[1];
 
-    return disjoint_decomp_join_results(
-      disjoint_decomp_complete_recursive(orbits_recurse[0],
-                                         restricted_subgroups.first),
-      disjoint_decomp_complete_recursive(orbits_recurse[1],
-                                         restricted_subgroups.second));
+    if (parallel_depth == 0u) {
+      return disjoint_decomp_join_results(
+        disjoint_decomp_complete_recursive(orbits_recurse[0],
+                                           restricted_subgroups.first,
+                                           options,
+                                           aborted),
+        disjoint_decomp_complete_recursive(orbits_recurse[1],
+                                           restricted_subgroups.second,
+                                           options,
+                                           aborted));
+    }
+
+    // both halves are independent, decompose one of them asynchronously
+    auto res1(std::async(std::launch::async,
+                         disjoint_decomp_complete_recursive,
+                         std::cref(orbits_recurse[0]),
+                         std::cref(restricted_subgroups.first),
+                         options,
+                         aborted,
+                         parallel_depth - 1u));
+
+    auto res2(disjoint_decomp_complete_recursive(orbits_recurse[1],
+                                                 restricted_subgroups.second,
+                                                 options,
+                                                 aborted,
+                                                 parallel_depth - 1u));
+
+    return disjoint_decomp_join_results(res1.get(), res2);
   }
 
   DBG(TRACE) << "No further decomposition possible, returning group";
@@ -194,25 +270,55 @@ std::vector<PermGroup> PermGroup::disjoint_decomp_complete_recursive(
 }
 
 std::vector<PermGroup> PermGroup::disjoint_decomp_complete(
-  bool disjoint_orbit_optimization) const
+  bool disjoint_orbit_optimization,
+  BSGSOptions const *options,
+  timeout::flag aborted) const
 {
   DBG(DEBUG) << "Finding (complete) disjoint subgroup decomposition for:";
   DBG(DEBUG) << *this;
 
-  OrbitPartition orbits(degree(), generators());
+  // start from singleton orbits and coarsen them one generator at a time
+  std::vector<int> singletons(degree());
+  std::iota(singletons.begin(), singletons.end(), 0);
+
+  OrbitPartition orbits(degree(), singletons);
+
+  for (Perm const &gen : generators()) {
+    timeout::check(aborted, "disjoint_decomposition");
+
+    orbits.add_generator(gen);
+  }
 
   DBG(TRACE) << "Orbit decomposition:";
   DBG(TRACE) << orbits;
 
   if (disjoint_orbit_optimization) {
     DBG(TRACE) << "Using dependent orbit optimization";
-    disjoint_decomp_generate_dependency_classes(orbits);
+
+    TIMER_START("disjoint decomp dependency classes");
+
+    disjoint_decomp_generate_dependency_classes(orbits, aborted);
+
+    TIMER_STOP("disjoint decomp dependency classes");
 
     DBG(TRACE) << "=> Grouped dependency class unions:";
     DBG(TRACE) << orbits;
   }
 
-  auto decomp(disjoint_decomp_complete_recursive(orbits, *this));
+  // recurse in parallel until every hardware thread is occupied
+  unsigned parallel_depth = 0u;
+  for (unsigned t = std::thread::hardware_concurrency(); t > 1u; t >>= 1)
+    ++parallel_depth;
+
+  TIMER_START("disjoint decomp complete");
+
+  auto decomp(disjoint_decomp_complete_recursive(orbits,
+                                                 *this,
+                                                 options,
+                                                 aborted,
+                                                 parallel_depth));
+
+  TIMER_STOP("disjoint decomp complete");
 
   DBG(DEBUG) << "Found disjoint subgroup decomposition:";
   for (PermGroup const &pg : decomp)
@@ -342,7 +448,8 @@ void PermGroup::disjoint_decomp_merge_equivalence_classes(
   TIMER_STOP("disjoint decomp merge equiv classes");
 }
 
-std::vector<PermGroup> PermGroup::disjoint_decomp_incomplete() const
+std::vector<PermGroup> PermGroup::disjoint_decomp_incomplete(
+  BSGSOptions const *options) const
 {
   DBG(DEBUG) << "Finding (incomplete) disjoint subgroup decomposition for:";
   DBG(DEBUG) << *this;
@@ -358,7 +465,8 @@ std::vector<PermGroup> PermGroup::disjoint_decomp_incomplete() const
     if (equivalence_classes[j].merged)
       continue;
 
-    decomp.emplace_back(degree(), equivalence_classes[j].generators);
+    decomp.emplace_back(
+      BSGS(degree(), equivalence_classes[j].generators, options));
   }
 
   TIMER_STOP("disjoint decomp construct groups");
@@ -9,6 +9,7 @@
 #include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
+#include "timeout.hpp"
 
 namespace mpsym
 {
@@ -16,12 +17,15 @@ namespace mpsym
 namespace internal
 {
 
-std::vector<PermGroup> PermGroup::wreath_decomposition() const
+std::vector<PermGroup> PermGroup::wreath_decomposition(
+  timeout::flag aborted) const
 {
   DBG(DEBUG) << "Finding wreath product decomposition for";
   DBG(DEBUG) << *this;
 
-  for (BlockSystem const &block_system : BlockSystem::non_trivial(*this)) {
+  for (BlockSystem const &block_system : block_systems(aborted)) {
+    timeout::check(aborted, "wreath_decomposition");
+
     DBG(TRACE) << "Considering block system:";
     DBG(TRACE) << block_system;
 
@@ -2,18 +2,53 @@
 #include <climits>
 #include <cmath>
 #include <random>
-#include <unordered_set>
 #include <vector>
 
-#include <boost/math/special_functions/prime.hpp>
-#include <boost/multiprecision/miller_rabin.hpp>
-
+#include "block_system.hpp"
 #include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
 #include "pr_randomizer.hpp"
 #include "util.hpp"
 
+namespace
+{
+
+// number of point pairs for which minimal block systems are computed in order
+// to rule out primitivity before any random elements are drawn
+constexpr unsigned ALTSYM_BLOCK_PROBES = 4u;
+
+bool is_prime(unsigned n)
+{
+  if (n < 2u)
+    return false;
+
+  for (unsigned d = 2u; d * d <= n; ++d) {
+    if (n % d == 0u)
+      return false;
+  }
+
+  return true;
+}
+
+// a transitive group containing an element with a cycle of prime length p,
+// n/2 < p < n - 2 contains the alternating group (Jordan)
+bool has_jordan_cycle(mpsym::internal::Perm const &perm)
+{
+  unsigned n = perm.degree();
+
+  for (auto const &cycle : perm.cycles()) {
+    unsigned cycle_len = static_cast<unsigned>(cycle.size());
+
+    if (cycle_len > n / 2u && cycle_len < n - 2u && is_prime(cycle_len))
+      return true;
+  }
+
+  return false;
+}
+
+} // anonymous namespace
+
 namespace mpsym
 {
 
@@ -23,7 +58,8 @@ namespace internal
 PrRandomizer::PrRandomizer(PermSet const &generators,
                            unsigned n_generators,
                            unsigned iterations)
-: _gens_orig(generators)
+: _gens_orig(generators),
+  _warmup(iterations)
 {
   generators.assert_not_empty();
 
@@ -43,14 +79,20 @@ PrRandomizer::PrRandomizer(PermSet const &generators,
       }
     }
   }
-
-  for (unsigned i = 0u; i < iterations; ++i)
-    next();
 }
 
 Perm PrRandomizer::next()
 {
-  static auto re(util::random_engine());
+  // warm up lazily so that tests which never sample don't pay for it
+  for (; _warmup > 0u; --_warmup)
+    shuffle();
+
+  return shuffle();
+}
+
+Perm PrRandomizer::shuffle()
+{
+  static thread_local auto re(util::random_engine());
 
   std::uniform_int_distribution<> randbool(0, 1);
   std::uniform_int_distribution<> rands(1, _gens.size() - 1);
@@ -74,10 +116,10 @@ Perm PrRandomizer::next()
 
 bool PrRandomizer::test_symmetric(double epsilon)
 {
-  if (!test_altsym(epsilon))
+  if (generators_even())
     return false;
 
-  return !generators_even();
+  return test_altsym(epsilon);
 }
 
 bool PrRandomizer::test_altsym(double epsilon)
@@ -86,27 +128,34 @@ bool PrRandomizer::test_altsym(double epsilon)
 
   assert(_gens_orig.degree() >= 8u);
 
-  // build prime number lookup table
-  static std::unordered_set<unsigned> prime_lookup;
+  unsigned n = _gens_orig.degree();
 
-  if (prime_lookup.empty()) {
-    //for (auto i = 0u; i <= boost::math::max_prime; ++i)
-    for (auto i = 0u; i <= 1000u; ++i)
-      prime_lookup.insert(boost::math::prime(i));
+  // check whether group is even transitive
+  if (OrbitPartition(n, _gens_orig).num_partitions() != 1u)
+    return false;
+
+  // check whether the group is obviously imprimitive
+  for (unsigned x = 1u; x <= ALTSYM_BLOCK_PROBES && x < n; ++x) {
+    if (!BlockSystem::minimal(_gens_orig, {0u, x}).trivial())
+      return false;
   }
 
-  // check whether group is even transitive
-  auto orbit(Orbit::generate(1, _gens_orig.with_inverses()));
+  // check whether the generators already contain a p-cycle
+  for (auto const &gen : _gens_orig) {
+    if (has_jordan_cycle(gen))
+      return true;
+  }
 
-  if (orbit.size() != _gens_orig.degree())
-    return false;
+  // determine number of random elements to be tested, for p > n/2 exactly a
+  // fraction of 1/p of the elements of Alt(n) and Sym(n) contain a p-cycle
+  double d = 0.0;
+  for (unsigned p = n / 2u + 1u; p < n - 2u; ++p) {
+    if (is_prime(p))
+      d += 1.0 / static_cast<double>(p);
+  }
 
-  // determine number of random elements to be tested
-  double d = std::log(2.0) / std::log(static_cast<double>(_gens_orig.degree()));
-  if (_gens_orig.degree() <= 16u)
-    d *= 0.23;
-  else
-    d *= 0.39;
+  if (d == 0.0)
+    return false;
 
   double iterations_lower_bound = -std::log(epsilon) / d;
   assert(iterations_lower_bound < static_cast<double>(UINT_MAX));
@@ -115,23 +164,9 @@ bool PrRandomizer::test_altsym(double epsilon)
     static_cast<unsigned>(std::ceil(iterations_lower_bound));
 
   // test whether random element contains p-cycle
-  unsigned p_lower_bound = _gens_orig.degree() / 2u;
-  unsigned p_upper_bound = _gens_orig.degree() - 2u;
-
   for (unsigned i = 0u; i < iterations; ++i) {
-    for (auto const &cycle : next().cycles()) {
-      auto cycle_len = cycle.size();
-
-      bool is_prime = cycle_len <= boost::math::max_prime ?
-        prime_lookup.find(cycle_len) != prime_lookup.end() :
-        boost::multiprecision::miller_rabin_test(cycle_len, 25);
-
-      if (!is_prime)
-        continue;
-
-      if (cycle_len > p_lower_bound && cycle_len < p_upper_bound)
-        return true;
-    }
+    if (has_jordan_cycle(next()))
+      return true;
   }
 
   return false;
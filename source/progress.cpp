@@ -0,0 +1,40 @@
+#include <stdexcept>
+
+#include "progress.hpp"
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+namespace progress
+{
+
+char const *phase_name(Phase phase)
+{
+  switch (phase) {
+    case Phase::SCHREIER_SIMS:
+      return "schreier_sims";
+    case Phase::SCHREIER_SIMS_RANDOM:
+      return "schreier_sims_random";
+    case Phase::REPR_ITERATE:
+      return "repr_iterate";
+    case Phase::REPR_ORBITS:
+      return "repr_orbits";
+    case Phase::REPR_LOCAL_SEARCH:
+      return "repr_local_search";
+    case Phase::REPR_LOCAL_SEARCH_SA:
+      return "repr_local_search_sa";
+    case Phase::ORBIT_ENUMERATION:
+      return "orbit_enumeration";
+  }
+
+  throw std::logic_error("unreachable");
+}
+
+} // namespace progress
+
+} // namespace internal
+
+} // namespace mpsym
@@ -6,6 +6,7 @@
 #include <utility>
 #include <vector>
 
+#include "instrument.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
 #include "schreier_tree.hpp"
@@ -59,6 +60,8 @@ bool SchreierTree::incoming(unsigned node, Perm const &edge) const
 
 Perm SchreierTree::transversal(unsigned origin) const
 {
+  INSTRUMENT_COUNT(TRANSVERSAL);
+
   Perm result(_degree);
 
   unsigned current = origin;
@@ -17,22 +17,31 @@ void TMO::IterationState::advance()
   if (exhausted())
     return;
 
+  if (_poll)
+    (*_poll)("orbit enumeration");
+
   auto current_copy(*current);
   _unprocessed.erase(current);
 
-  if (_singular)
-    return;
+  if (!_singular) {
+    _processed.insert(_hash(current_copy));
 
-  _processed.insert(_hash(current_copy));
+    for (auto const &gen : *_generators) {
+      TaskMapping next(current_copy.permuted(gen));
 
-  for (auto const &gen : *_generators) {
-    TaskMapping next(current_copy.permuted(gen));
+      if (_processed.find(_hash(next)) == _processed.end())
+        _unprocessed.insert(next);
+    }
 
-    if (_processed.find(_hash(next)) == _processed.end())
-      _unprocessed.insert(next);
+    current = _unprocessed.begin();
   }
 
-  current = _unprocessed.begin();
+  _progress.state.elements = _progress.state.processed + 1ULL;
+  _progress.state.remaining = static_cast<double>(_unprocessed.size());
+  _progress.tick();
+
+  if (exhausted())
+    _progress.finish();
 }
 
 bool TMO::IterationState::exhausted() const
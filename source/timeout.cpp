@@ -3,6 +3,8 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
+#include <utility>
 
 namespace mpsym
 {
@@ -17,6 +19,55 @@ std::atomic<int> _timeout_thread_count(0);
 std::condition_variable _timeout_thread_count_cv;
 std::mutex _timeout_thread_count_mtx;
 
+WorkerPool &WorkerPool::instance()
+{
+  // intentionally leaked, see header
+  static WorkerPool *pool = new WorkerPool;
+
+  return *pool;
+}
+
+void WorkerPool::submit(job j)
+{
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  _jobs.push_back(std::move(j));
+
+  if (_jobs.size() > _idle) {
+    std::thread(&WorkerPool::work, this).detach();
+    ++_num_workers;
+  } else {
+    _cv.notify_one();
+  }
+}
+
+unsigned WorkerPool::num_workers() const
+{
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  return _num_workers;
+}
+
+void WorkerPool::work()
+{
+  std::unique_lock<std::mutex> lock(_mtx);
+
+  for (;;) {
+    ++_idle;
+    _cv.wait(lock, [&]{ return !_jobs.empty(); });
+    --_idle;
+
+    auto j(std::move(_jobs.front()));
+    _jobs.pop_front();
+
+    lock.unlock();
+
+    j();
+
+    lock.lock();
+  }
+}
+
 } // namespace timeout
 
 } // namespace internal
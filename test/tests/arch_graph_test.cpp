@@ -1,20 +1,29 @@
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 
 #include "arch_graph.hpp"
+#include "arch_graph_automorphisms.hpp"
 #include "arch_graph_cluster.hpp"
 #include "arch_graph_system.hpp"
 #include "arch_uniform_super_graph.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
+#include "perm_group_cache.hpp"
+#include "progress.hpp"
 #include "task_mapping.hpp"
+#include "task_mapping_orbit.hpp"
 #include "test_utility.hpp"
+#include "timeout.hpp"
 
 #include "test_main.cpp"
 
@@ -440,6 +449,32 @@ TEST_F(ArchGraphClusterTest, CanObtainAutormorphisms)
     << "Automorphisms of minimal architecture graph cluster correct.";
 }
 
+TEST_F(ArchGraphClusterTest, CanAbortAutomorphisms)
+{
+  auto aborted(timeout::unset());
+  timeout::set(aborted);
+
+  EXPECT_THROW(cluster_minimal->automorphisms(nullptr, aborted),
+               timeout::AbortedError)
+    << "Determining subsystem automorphisms aborted.";
+
+  auto cluster(std::make_shared<ArchGraphCluster>());
+  cluster->add_subsystem(
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup::symmetric(4)));
+  cluster->add_subsystem(
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup::cyclic(4)));
+
+  AutomorphismOptions options;
+  options.construction = BSGSOptions::Construction::SCHREIER_SIMS;
+
+  EXPECT_THROW(cluster->automorphisms(&options, aborted),
+               timeout::AbortedError)
+    << "Determining direct product of subsystem automorphisms aborted.";
+
+  EXPECT_EQ(96u, cluster->automorphisms(&options).order())
+    << "Automorphisms determined after unsuccessful attempt.";
+}
+
 class ArchGraphClusterReprVariantTest :
   public ArchGraphClusterTestBase<testing::TestWithParam<ReprOptions::Method>>
 {};
@@ -552,3 +587,578 @@ TEST_F(ArchUniformSuperGraphTest, CanObtainAutormorphisms)
   EXPECT_EQ(expected_automorphisms, super_graph_minimal->automorphisms())
     << "Automorphisms of uniform architecture super_graph correct.";
 }
+
+TEST_F(ArchUniformSuperGraphTest, CanRestoreFromSnapshot)
+{
+  super_graph_minimal->init_repr();
+
+  auto snapshot(super_graph_minimal->to_snapshot());
+  auto super_graph_restored(ArchGraphSystem::from_snapshot(snapshot));
+
+  EXPECT_TRUE(super_graph_restored->repr_ready())
+    << "Representative state restored from snapshot.";
+
+  EXPECT_EQ(super_graph_minimal->to_json(), super_graph_restored->to_json())
+    << "Uniform architecture super_graph structure restored from snapshot.";
+
+  for (unsigned i = 0u; i < 12u; ++i) {
+    for (unsigned j = 0u; j < 12u; ++j) {
+      TaskMapping mapping({i, j});
+
+      EXPECT_EQ(super_graph_minimal->repr(mapping),
+                super_graph_restored->repr(mapping))
+        << "Representatives correct after restoring from snapshot.";
+    }
+  }
+
+  EXPECT_THROW(ArchGraphSystem::from_snapshot(snapshot.substr(4u)),
+               std::runtime_error)
+    << "Malformed snapshot rejected.";
+
+  EXPECT_THROW(ArchGraphSystem::from_snapshot(snapshot + std::string(4u, '\0')),
+               std::runtime_error)
+    << "Trailing snapshot data rejected.";
+}
+
+TEST(ArchGraphBinaryTest, CanRestoreSystemType)
+{
+  auto cluster(std::make_shared<ArchGraphCluster>());
+  cluster->add_subsystem(
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup::symmetric(3)));
+  cluster->add_subsystem(
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup::cyclic(4)));
+
+  auto binary(cluster->to_binary());
+  auto restored(ArchGraphSystem::from_binary(binary));
+
+  auto cluster_restored(std::dynamic_pointer_cast<ArchGraphCluster>(restored));
+
+  ASSERT_TRUE(cluster_restored != nullptr)
+    << "Architecture graph cluster restored as cluster.";
+
+  EXPECT_EQ(2u, cluster_restored->num_subsystems())
+    << "Architecture graph cluster subsystems restored.";
+
+  EXPECT_TRUE(cluster_restored->automorphisms_ready())
+    << "Automorphisms restored along with system.";
+
+  EXPECT_EQ(cluster->automorphisms(), cluster_restored->automorphisms())
+    << "Automorphisms restored correctly.";
+
+  auto bsgs_binary(PermGroup::symmetric(5).bsgs().to_binary());
+  auto automorphisms(ArchGraphSystem::from_binary(bsgs_binary));
+
+  EXPECT_TRUE(std::dynamic_pointer_cast<ArchGraphAutomorphisms>(automorphisms))
+    << "Plain BSGS binary restored as explicit automorphism group.";
+
+  EXPECT_EQ(PermGroup::symmetric(5), automorphisms->automorphisms())
+    << "Automorphisms restored correctly from plain BSGS binary.";
+}
+
+TEST(ArchGraphBinaryTest, CanRestorePresetAutomorphisms)
+{
+  auto ag(ArchGraph::torus({3, 3}));
+
+  auto restored(ArchGraphSystem::from_snapshot(ag->to_snapshot()));
+
+  EXPECT_FALSE(restored->automorphisms_ready())
+    << "Preset automorphisms not constructed before snapshot.";
+
+  EXPECT_EQ(ag->automorphisms(), restored->automorphisms())
+    << "Preset automorphisms restored along with system.";
+}
+
+TEST(ArchGraphGroupCacheTest, IsomorphicGraphsShareCachedGroups)
+{
+  PermGroupCache::global().clear();
+
+  AutomorphismOptions options;
+  options.use_group_cache = true;
+
+  // the same path, labeled 0-1-2-3 and 1-0-2-3
+  ArchGraph ag1(false), ag2(false);
+
+  ag1.add_processors(4u, "P");
+  ag1.add_channel(0, 1, "C");
+  ag1.add_channel(1, 2, "C");
+  ag1.add_channel(2, 3, "C");
+
+  ag2.add_processors(4u, "P");
+  ag2.add_channel(1, 0, "C");
+  ag2.add_channel(0, 2, "C");
+  ag2.add_channel(2, 3, "C");
+
+  auto automorphisms1(ag1.automorphisms(&options));
+  auto num_keys(PermGroupCache::global().num_keys());
+
+  auto automorphisms2(ag2.automorphisms(&options));
+
+  EXPECT_EQ(num_keys + 1u, PermGroupCache::global().num_keys())
+    << "Isomorphic graph found in cache (only its description added).";
+
+  EXPECT_EQ(PermGroup(4, {Perm(4, {{0, 3}, {1, 2}})}), automorphisms1)
+    << "Automorphisms of first graph correct.";
+
+  EXPECT_EQ(PermGroup(4, {Perm(4, {{0, 2}, {1, 3}})}), automorphisms2)
+    << "Automorphisms of second graph correctly relabeled.";
+
+  PermGroupCache::global().clear();
+}
+
+TEST(ArchGraphGroupCacheTest, ReportsDiskCacheErrors)
+{
+  std::vector<std::string> errors;
+
+  AutomorphismOptions options;
+  options.group_cache_dir = "/nonexistent/mpsym/group/cache";
+  options.group_cache_error_callback = [&](std::string const &error){
+    errors.push_back(error);
+  };
+
+  ArchGraph ag(false);
+
+  ag.add_processors(4u, "P");
+  ag.add_channel(0, 1, "C");
+  ag.add_channel(1, 2, "C");
+  ag.add_channel(2, 3, "C");
+
+  EXPECT_EQ(PermGroup(4, {Perm(4, {{0, 3}, {1, 2}})}),
+            ag.automorphisms(&options))
+    << "Automorphisms correct despite unwritable disk cache.";
+
+  EXPECT_EQ(2u, errors.size())
+    << "Failing to write disk cache entries reported.";
+}
+
+TEST(ArchGraphDecompositionTest, CanDecomposeRepr)
+{
+  PermGroup automorphisms(8,
+    {
+      Perm(8, {{0, 1}}),
+      Perm(8, {{2, 3}}),
+      Perm(8, {{0, 2}, {1, 3}}),
+      Perm(8, {{4, 5, 6, 7}})
+    }
+  );
+
+  auto ag(std::make_shared<ArchGraphAutomorphisms>(automorphisms));
+  auto ag_decomposed(std::make_shared<ArchGraphAutomorphisms>(automorphisms));
+
+  AutomorphismOptions options;
+  options.decompose_repr = true;
+
+  // automorphisms already determined, decomposition must happen nonetheless
+  ag_decomposed->automorphisms();
+  ag_decomposed->init_repr(&options);
+
+  EXPECT_EQ(2u, ag_decomposed->num_repr_factors())
+    << "Automorphisms decomposed.";
+
+  std::unordered_map<TaskMapping, TaskMapping> reprs;
+  std::unordered_set<TaskMapping> reprs_decomposed;
+
+  for (unsigned i = 0u; i < 8u; ++i) {
+    for (unsigned j = 0u; j < 8u; ++j) {
+      for (unsigned k = 0u; k < 8u; ++k) {
+        TaskMapping mapping({i, j, k});
+
+        auto repr(ag->repr(mapping));
+        auto repr_decomposed(ag_decomposed->repr(mapping));
+
+        auto it(reprs.find(repr));
+        if (it == reprs.end()) {
+          reprs[repr] = repr_decomposed;
+        } else {
+          EXPECT_EQ(it->second, repr_decomposed)
+            << "Decomposed representatives consistent.";
+        }
+
+        reprs_decomposed.insert(repr_decomposed);
+      }
+    }
+  }
+
+  EXPECT_EQ(reprs.size(), reprs_decomposed.size())
+    << "Decomposed representatives distinguish all orbits.";
+}
+
+TEST(ArchGraphTopologyTest, CanConstructCommonTopologies)
+{
+  struct Topology
+  {
+    std::string name;
+    std::shared_ptr<ArchGraph> ag;
+    unsigned num_processors;
+    unsigned num_channels;
+    unsigned long long num_automorphisms;
+  };
+
+  std::vector<Topology> topologies {
+    {"mesh 1", ArchGraph::mesh({1}), 1u, 0u, 1u},
+    {"mesh 5", ArchGraph::mesh({5}), 5u, 4u, 2u},
+    {"mesh 3x3", ArchGraph::mesh({3, 3}), 9u, 12u, 8u},
+    {"mesh 2x1x3", ArchGraph::mesh({2, 1, 3}), 6u, 7u, 4u},
+    {"mesh 2x3x2", ArchGraph::mesh({2, 3, 2}), 12u, 20u, 16u},
+    {"torus 2", ArchGraph::torus({2}), 2u, 1u, 2u},
+    {"torus 5", ArchGraph::torus({5}), 5u, 5u, 10u},
+    {"torus 3x3", ArchGraph::torus({3, 3}), 9u, 18u, 72u},
+    {"torus 3x5", ArchGraph::torus({3, 5}), 15u, 30u, 60u},
+    {"torus 4", ArchGraph::torus({4}), 4u, 4u, 8u},
+    {"torus 2x4", ArchGraph::torus({2, 4}), 8u, 12u, 48u},
+    {"torus 3x4", ArchGraph::torus({3, 4}), 12u, 24u, 48u},
+    {"hypercube 3", ArchGraph::hypercube(3), 8u, 12u, 48u},
+    {"hypercube 4", ArchGraph::hypercube(4), 16u, 32u, 384u},
+    {"fat tree 2x1", ArchGraph::fat_tree(2, 1), 3u, 2u, 2u},
+    {"fat tree 2x3", ArchGraph::fat_tree(2, 3), 15u, 14u, 128u},
+    {"fat tree 3x2", ArchGraph::fat_tree(3, 2), 13u, 12u, 1296u}
+  };
+
+  for (auto const &topology : topologies) {
+    auto ag(topology.ag);
+
+    EXPECT_EQ(topology.num_processors, ag->num_processors())
+      << "Number of processors correct (" << topology.name << ").";
+
+    EXPECT_EQ(topology.num_channels, ag->num_channels())
+      << "Number of channels correct (" << topology.name << ").";
+
+    EXPECT_EQ(topology.num_automorphisms, ag->num_automorphisms())
+      << "Number of automorphisms correct (" << topology.name << ").";
+
+    auto ag_nauty(ArchGraphSystem::from_json(ag->to_json()));
+
+    EXPECT_EQ(ag_nauty->automorphisms(), ag->automorphisms())
+      << "Automorphisms agree with those determined by nauty ("
+      << topology.name << ").";
+  }
+}
+
+TEST(ArchGraphTopologyTest, FatTreeChannelsWidenTowardsRoot)
+{
+  ArchGraph expected(false);
+
+  expected.add_processors(4u, "P");
+  expected.add_processors(3u, "S");
+
+  for (unsigned pe = 0u; pe < 4u; ++pe)
+    expected.add_channel(pe, 4u + pe / 2u, "C1");
+
+  expected.add_channel(4u, 6u, "C2");
+  expected.add_channel(5u, 6u, "C2");
+
+  EXPECT_EQ(expected.to_json(), ArchGraph::fat_tree(2, 2)->to_json())
+    << "Fat tree channel types correct.";
+}
+
+TEST(ArchGraphTopologyTest, PresetAutomorphismsRespectOptions)
+{
+  auto ag(ArchGraph::torus({8, 8}));
+
+  AutomorphismOptions options;
+  options.transversals = AutomorphismOptions::Transversals::EXPLICIT;
+
+  auto automorphisms_explicit(ag->automorphisms(&options));
+
+  ag->reset_automorphisms();
+
+  options.transversals = AutomorphismOptions::Transversals::SCHREIER_TREES;
+
+  auto automorphisms_schreier_trees(ag->automorphisms(&options));
+
+  EXPECT_EQ(automorphisms_explicit, automorphisms_schreier_trees)
+    << "Automorphisms independent of transversal storage.";
+
+  EXPECT_LT(automorphisms_schreier_trees.bsgs().memory_usage(),
+            automorphisms_explicit.bsgs().memory_usage())
+    << "Transversal storage option applied to preset automorphisms.";
+
+  auto ag_large(ArchGraph::hypercube(10));
+
+  AutomorphismOptions options_large;
+  options_large.transversals = AutomorphismOptions::Transversals::SCHREIER_TREES;
+
+  EXPECT_EQ(ag_large->automorphisms(&options_large).bsgs().memory_usage(),
+            ArchGraph::hypercube(10)->automorphisms().bsgs().memory_usage())
+    << "Preset automorphisms of large topologies use Schreier trees by default.";
+}
+
+TEST(ArchGraphTopologyTest, ModifyingTopologyResetsAutomorphisms)
+{
+  auto ag(ArchGraph::mesh({3, 3}));
+
+  ag->add_channel(0, 8, "C");
+
+  EXPECT_FALSE(ag->automorphisms_ready())
+    << "Automorphisms reset after modification.";
+
+  EXPECT_EQ(4u, ag->num_automorphisms())
+    << "Automorphisms redetermined after modification.";
+}
+
+TEST(ArchGraphNautyEncodingTest, EncodingsAgree)
+{
+  for (bool directed : {false, true}) {
+    // 2x4 mesh with distinct horizontal and vertical channels, additional
+    // express channels along the rows and local memory on every other processor
+    ArchGraph ag(directed);
+
+    ag.add_processors(8u, "P");
+
+    for (unsigned pe = 0u; pe < 8u; ++pe) {
+      if (pe % 4u < 3u)
+        ag.add_channel(pe, pe + 1u, "H");
+
+      if (pe < 4u)
+        ag.add_channel(pe, pe + 4u, "V");
+
+      if (pe % 4u < 2u)
+        ag.add_channel(pe, pe + 2u, "E");
+
+      if (pe % 2u == 0u)
+        ag.add_channel(pe, pe, "M");
+    }
+
+    ag.set_nauty_encoding(ArchGraph::NautyEncoding::LAYERED);
+    auto automorphisms_layered(ag.automorphisms());
+
+    ag.reset_automorphisms();
+
+    ag.set_nauty_encoding(ArchGraph::NautyEncoding::SUBDIVIDED);
+    auto automorphisms_subdivided(ag.automorphisms());
+
+    std::string which(directed ? "directed" : "undirected");
+
+    EXPECT_EQ(automorphisms_layered, automorphisms_subdivided)
+      << "Automorphisms independent of channel type encoding (" << which << ").";
+
+    EXPECT_EQ(directed ? 1u : 2u, automorphisms_layered.order())
+      << "Automorphisms respect channel types (" << which << ").";
+  }
+}
+
+TEST(ArchGraphReprBatchTest, CanComputeReprBatch)
+{
+  auto ag(std::make_shared<ArchGraphAutomorphisms>(PermGroup::dihedral(12)));
+
+  std::vector<unsigned> mappings;
+  for (unsigned i = 0u; i < 12u; ++i) {
+    for (unsigned j = 0u; j < 12u; ++j) {
+      mappings.push_back(i);
+      mappings.push_back(j);
+      mappings.push_back((i + j) % 12u);
+    }
+  }
+
+  unsigned num_mappings = static_cast<unsigned>(mappings.size() / 3u);
+
+  std::vector<unsigned> expected;
+  for (unsigned i = 0u; i < num_mappings; ++i) {
+    auto repr(ag->repr(TaskMapping({mappings[3u * i],
+                                    mappings[3u * i + 1u],
+                                    mappings[3u * i + 2u]})));
+
+    expected.insert(expected.end(), repr.begin(), repr.end());
+  }
+
+  for (unsigned num_threads : {1u, 4u}) {
+    std::vector<unsigned> reprs(mappings.size());
+
+    ag->repr_batch(mappings.data(),
+                   reprs.data(),
+                   num_mappings,
+                   3u,
+                   nullptr,
+                   num_threads);
+
+    EXPECT_EQ(expected, reprs)
+      << "Batched representatives correct (" << num_threads << " threads).";
+  }
+
+  ag->repr_batch(mappings.data(), mappings.data(), num_mappings, 3u);
+
+  EXPECT_EQ(expected, mappings)
+    << "Batched representatives correct in place.";
+}
+
+TEST(ArchGraphReprBatchTest, CanComputePreparedReprConcurrently)
+{
+  auto make_cluster = []{
+    auto cluster(std::make_shared<ArchGraphCluster>());
+    cluster->add_subsystem(ArchGraph::mesh({2, 2}));
+    cluster->add_subsystem(ArchGraph::torus({8}));
+
+    return cluster;
+  };
+
+  auto make_decomposable = []{
+    return std::make_shared<ArchGraphAutomorphisms>(
+      PermGroup(12, {Perm(12, {{0, 1, 2}}),
+                     Perm(12, {{0, 1}}),
+                     Perm(12, {{3, 4, 5, 6, 7, 8, 9, 10, 11}})}));
+  };
+
+  AutomorphismOptions options;
+  options.decompose_repr = true;
+
+  std::vector<TaskMapping> mappings;
+  for (unsigned i = 0u; i < 12u; ++i) {
+    for (unsigned j = 0u; j < 12u; ++j)
+      mappings.push_back(TaskMapping({i, j, (i + j) % 12u}));
+  }
+
+  std::vector<std::pair<std::shared_ptr<ArchGraphSystem>,
+                        std::shared_ptr<ArchGraphSystem>>> const systems {
+    {make_cluster(), make_cluster()},
+    {make_decomposable(), make_decomposable()}
+  };
+
+  for (auto const &system : systems) {
+    auto ags(system.first);
+    auto ags_prepared(system.second);
+
+    ags->init_repr(&options);
+    ags_prepared->prepare_repr(&options);
+
+    std::vector<TaskMapping> expected;
+    for (auto const &mapping : mappings)
+      expected.push_back(ags->repr(mapping));
+
+    std::vector<std::vector<TaskMapping>> reprs(4u);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0u; t < reprs.size(); ++t) {
+      threads.emplace_back([&, t]{
+        for (auto const &mapping : mappings)
+          reprs[t].push_back(ags_prepared->repr_prepared(mapping));
+      });
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+
+    for (auto const &repr : reprs) {
+      EXPECT_EQ(expected, repr)
+        << "Prepared representatives correct.";
+    }
+  }
+
+  EXPECT_EQ(2u, systems[1].second->num_repr_factors())
+    << "Prepared representatives determined over decomposition.";
+}
+
+TEST(ArchGraphReprBatchTest, CanAbortLazyReprInitialization)
+{
+  ArchGraph ag(false);
+
+  ag.add_processors(4u, "P");
+  ag.add_channel(0, 1, "C");
+  ag.add_channel(1, 2, "C");
+  ag.add_channel(2, 3, "C");
+
+  auto aborted(timeout::unset());
+  timeout::set(aborted);
+
+  EXPECT_THROW(ag.repr(TaskMapping({0u, 1u}), nullptr, aborted),
+               timeout::AbortedError)
+    << "Determining automorphisms for representative aborted.";
+
+  EXPECT_EQ(TaskMapping({0u, 1u}), ag.repr(TaskMapping({3u, 2u})))
+    << "Representative correct after aborted initialization.";
+}
+
+TEST(ArchGraphOrbitTest, CanAbortOrbitEnumeration)
+{
+  auto orbit_size = [](TMO const &orbit){
+    unsigned size = 0u;
+    for (auto it = orbit.begin(); it != orbit.end(); ++it)
+      ++size;
+
+    return size;
+  };
+
+  auto ag(std::make_shared<ArchGraphAutomorphisms>(PermGroup::symmetric(8)));
+
+  auto orbit(ag->automorphisms_orbit(TaskMapping({0u, 1u, 2u})));
+
+  EXPECT_EQ(336u, orbit_size(orbit))
+    << "Orbit enumerated completely.";
+
+  auto aborted(timeout::unset());
+
+  auto abortable_orbit(ag->automorphisms_orbit(TaskMapping({0u, 1u, 2u}),
+                                               nullptr,
+                                               timeout::unset(),
+                                               aborted));
+
+  EXPECT_EQ(336u, orbit_size(abortable_orbit))
+    << "Orbit enumerated completely while flag unset.";
+
+  timeout::set(aborted);
+
+  EXPECT_THROW(orbit_size(abortable_orbit),
+               timeout::AbortedError)
+    << "Orbit enumeration aborted.";
+}
+
+TEST(ArchGraphOrbitTest, CanReportOrbitEnumerationProgress)
+{
+  auto ag(std::make_shared<ArchGraphAutomorphisms>(PermGroup::symmetric(8)));
+
+  std::vector<progress::State> states;
+
+  AutomorphismOptions options;
+  options.progress_interval = 0u;
+  options.progress_callback = [&](progress::State const &state)
+                              { states.push_back(state); };
+
+  auto orbit(ag->automorphisms_orbit(TaskMapping({0u, 1u, 2u}), &options));
+
+  states.clear();
+
+  for (auto it = orbit.begin(); it != orbit.end(); ++it)
+    ;
+
+  ASSERT_FALSE(states.empty())
+    << "Progress callback invoked.";
+
+  for (auto const &state : states) {
+    EXPECT_EQ(progress::Phase::ORBIT_ENUMERATION, state.phase)
+      << "Progress phase reported correctly.";
+  }
+
+  EXPECT_TRUE(states.back().finished)
+    << "Completion reported.";
+
+  EXPECT_EQ(336u, states.back().elements)
+    << "Number of enumerated orbit elements reported correctly.";
+}
+
+TEST(ArchGraphMemoryUsageTest, CanReportMemoryUsage)
+{
+  auto ag(std::make_shared<ArchGraphAutomorphisms>(PermGroup::dihedral(12)));
+
+  auto memory_usage_uninitialized = ag->memory_usage();
+
+  ag->automorphisms();
+
+  EXPECT_GT(ag->memory_usage(), memory_usage_uninitialized)
+    << "Memory usage includes cached automorphisms.";
+
+  TMORs orbits;
+  auto memory_usage_empty = orbits.memory_usage();
+
+  for (unsigned i = 0u; i < 12u; ++i)
+    ag->repr(TaskMapping({i, (i + 1u) % 12u}), orbits);
+
+  EXPECT_GT(orbits.memory_usage(), memory_usage_empty)
+    << "Memory usage of orbit representatives grows with their number.";
+
+  TMO orbit(TaskMapping({0u, 1u}), ag->automorphisms_generators());
+
+  auto it(orbit.begin());
+  for (unsigned i = 0u; i < 4u; ++i)
+    ++it;
+
+  EXPECT_GT(it.memory_usage(), 0u)
+    << "Memory usage of orbit iteration state reported.";
+}
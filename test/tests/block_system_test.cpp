@@ -163,3 +163,41 @@ TEST(BlockSystemTest, CanFindAllNonTrivialBlockSystemsForNonTransientGroup)
               block_systems[0]))
     << "Correct block systems determined.";
 }
+
+TEST(BlockSystemTest, CanFindAllNonTrivialBlockSystemsForRegularGroup)
+{
+  std::vector<unsigned> cycle(64u);
+  for (unsigned i = 0u; i < cycle.size(); ++i)
+    cycle[i] = (i + 1u) % cycle.size();
+
+  PermGroup pg(64, {Perm(cycle)});
+  PermGroup pg_copy(pg);
+
+  auto memory_usage_uncached(pg_copy.memory_usage());
+
+  auto block_systems(pg.block_systems());
+
+  ASSERT_EQ(5u, block_systems.size())
+    << "Correct number of block systems found.";
+
+  std::vector<unsigned> block_sizes;
+  for (auto const &bs : block_systems) {
+    block_sizes.push_back(bs[0].size());
+
+    for (auto const &block : bs) {
+      for (unsigned i = 1u; i < block.size(); ++i) {
+        EXPECT_EQ(block[0] + i * bs.size(), block[i])
+          << "Correct block systems determined.";
+      }
+    }
+  }
+
+  EXPECT_THAT(block_sizes, testing::UnorderedElementsAre(2u, 4u, 8u, 16u, 32u))
+    << "Correct block systems determined.";
+
+  EXPECT_EQ(5u, pg.block_systems().size())
+    << "Block systems cached correctly.";
+
+  EXPECT_GT(pg_copy.memory_usage(), memory_usage_uncached)
+    << "Block systems cache shared with earlier copies.";
+}
@@ -1,12 +1,21 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
+#include <unistd.h>
+
 #include "gmock/gmock.h"
 
+#include "binary.hpp"
 #include "bsgs.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
+#include "test_utility.hpp"
 
 #include "test_main.cpp"
 
@@ -47,6 +56,220 @@ TEST(DISABLED_BSGSSolveTest, CanSolveBSGS)
       << "Solving BSGS fails for non-solvable group generating set.";
 }
 
+TEST(BSGSProgressTest, CanReportProgress)
+{
+  PermSet generators {
+    Perm(12, {{0, 1, 2, 3, 4, 5}, {6, 7, 8, 9, 10, 11}}),
+    Perm(12, {{0, 6}, {1, 7}}),
+    Perm(12, {{2, 8}})
+  };
+
+  std::vector<progress::State> states;
+
+  BSGSOptions bsgs_options;
+  bsgs_options.construction = BSGSOptions::Construction::SCHREIER_SIMS;
+  bsgs_options.check_sym = false;
+  bsgs_options.progress_interval = 0u;
+  bsgs_options.progress_callback = [&](progress::State const &state)
+                                   { states.push_back(state); };
+
+  BSGS bsgs(generators, &bsgs_options);
+
+  ASSERT_FALSE(states.empty())
+    << "Progress callback invoked.";
+
+  for (auto const &state : states) {
+    EXPECT_EQ(progress::Phase::SCHREIER_SIMS, state.phase)
+      << "Progress phase reported correctly.";
+  }
+
+  for (auto i = 1u; i < states.size(); ++i) {
+    EXPECT_GE(states[i].schreier_generators, states[i - 1u].schreier_generators)
+      << "Number of processed Schreier generators is monotonic.";
+  }
+
+  EXPECT_TRUE(states.back().finished)
+    << "Completion reported.";
+
+  EXPECT_EQ(bsgs.base_size(), states.back().base_size)
+    << "Final base size reported correctly.";
+}
+
+TEST(BSGSMemoryUsageTest, CanReportMemoryUsage)
+{
+  for (auto transversals : {BSGSOptions::Transversals::EXPLICIT,
+                            BSGSOptions::Transversals::SCHREIER_TREES}) {
+    BSGSOptions bsgs_options;
+    bsgs_options.transversals = transversals;
+
+    BSGS bsgs_small(PermGroup::symmetric(4).generators(), &bsgs_options);
+    BSGS bsgs_large(PermGroup::symmetric(12).generators(), &bsgs_options);
+
+    auto levels(bsgs_large.level_memory_usage());
+
+    ASSERT_EQ(bsgs_large.base_size(), levels.size())
+      << "Memory usage reported for every level.";
+
+    std::size_t levels_total = 0u;
+    for (auto const &level : levels) {
+      EXPECT_GT(level.orbit, 0u)
+        << "Orbit memory usage reported.";
+
+      levels_total += level.total();
+    }
+
+    EXPECT_GT(bsgs_large.memory_usage(), levels_total)
+      << "Total memory usage includes base and strong generators.";
+
+    EXPECT_GT(bsgs_large.memory_usage(), bsgs_small.memory_usage())
+      << "Memory usage grows with group size.";
+
+    BSGS bsgs_copy(bsgs_large);
+
+    std::size_t levels_total_copy = 0u;
+    for (auto const &level : bsgs_copy.level_memory_usage())
+      levels_total_copy += level.total();
+
+    EXPECT_EQ(bsgs_copy.memory_usage() - levels_total_copy,
+              bsgs_copy.memory_usage(bsgs_large))
+      << "Schreier structures shared with copied BSGS not counted.";
+
+    EXPECT_EQ(bsgs_large.memory_usage(),
+              bsgs_large.memory_usage(bsgs_small))
+      << "Schreier structures of unrelated BSGS counted.";
+  }
+}
+
+TEST(BSGSStripTest, CanReuseBatchStripTables)
+{
+  BSGS bsgs(PermSet({Perm(6, {{0, 1, 2, 3, 4, 5}}), Perm(6, {{1, 5}, {2, 4}})}));
+
+  PermSet perms;
+  std::vector<bool> expected;
+
+  for (Perm const &perm : PermGroup::symmetric(6)) {
+    perms.insert(perm);
+    expected.push_back(bsgs.strips_completely(perm));
+  }
+
+  auto memory_usage_untabled(bsgs.memory_usage());
+
+  std::size_t levels_total = 0u;
+  for (auto const &level : bsgs.level_memory_usage())
+    levels_total += level.total();
+
+  EXPECT_EQ(expected, bsgs.strips_completely(perms, 1u))
+    << "Batch strip correct.";
+
+  EXPECT_GT(bsgs.memory_usage(), memory_usage_untabled)
+    << "Batch strip tables retained.";
+
+  BSGS bsgs_copy(bsgs);
+
+  EXPECT_EQ(memory_usage_untabled - levels_total, bsgs.memory_usage(bsgs_copy))
+    << "Batch strip tables shared with copies.";
+
+  EXPECT_EQ(expected, bsgs_copy.strips_completely(perms, 1u))
+    << "Batch strip correct using shared tables.";
+}
+
+TEST(BSGSBinaryTest, CanSerializeBSGS)
+{
+  std::vector<PermGroup> groups {
+    PermGroup::symmetric(6),
+    PermGroup::dihedral(8),
+    PermGroup(8, {Perm(8, {{0, 1, 2}, {4, 5}}), Perm(8, {{2, 3}, {6, 7}})}),
+    PermGroup(4)
+  };
+
+  std::vector<BSGSOptions::Transversals> transversals {
+    BSGSOptions::Transversals::EXPLICIT,
+    BSGSOptions::Transversals::SCHREIER_TREES
+  };
+
+  for (auto const &pg : groups) {
+    auto binary(pg.bsgs().to_binary());
+
+    for (auto transv : transversals) {
+      BSGSOptions bsgs_options;
+      bsgs_options.transversals = transv;
+
+      auto bsgs(BSGS::from_binary(binary, &bsgs_options));
+
+      EXPECT_EQ(pg.bsgs().base(), bsgs.base())
+        << "Base restored correctly.";
+
+      auto sgs_expected(pg.bsgs().strong_generators());
+      auto sgs(bsgs.strong_generators());
+
+      EXPECT_TRUE(sgs_expected.size() == sgs.size() &&
+                  std::equal(sgs_expected.begin(), sgs_expected.end(),
+                             sgs.begin()))
+        << "Strong generators restored correctly.";
+
+      EXPECT_EQ(pg.order(), bsgs.order())
+        << "Order restored correctly.";
+
+      EXPECT_EQ(pg.bsgs().is_symmetric(), bsgs.is_symmetric())
+        << "Symmetry flag restored correctly.";
+
+      PermGroup pg_restored(bsgs);
+
+      EXPECT_TRUE(perm_group_equal(pg, pg_restored))
+        << "Group restored correctly.";
+    }
+  }
+}
+
+TEST(BSGSBinaryTest, CanSerializeBSGSToFile)
+{
+  auto pg(PermGroup::dihedral(12));
+
+  char tmpname[] = "bsgs_binary_XXXXXX";
+  int fd = mkstemp(tmpname);
+  ASSERT_NE(-1, fd)
+    << "Created temporary file.";
+
+  close(fd);
+
+  pg.bsgs().to_binary_file(tmpname);
+
+  PermGroup pg_restored(BSGS::from_binary_file(tmpname));
+
+  std::remove(tmpname);
+
+  EXPECT_TRUE(perm_group_equal(pg, pg_restored))
+    << "Group restored correctly from file.";
+}
+
+TEST(BSGSBinaryTest, CanDetectMalformedBinary)
+{
+  auto binary(PermGroup::symmetric(5).bsgs().to_binary());
+
+  EXPECT_THROW(BSGS::from_binary(binary.substr(0u, binary.size() - 4u)),
+               std::runtime_error)
+    << "Truncated binary data rejected.";
+
+  EXPECT_THROW(BSGS::from_binary(binary + std::string(4u, '\0')),
+               std::runtime_error)
+    << "Trailing binary data rejected.";
+
+  auto binary_corrupted(binary);
+  binary_corrupted[0] = 'X';
+
+  EXPECT_THROW(BSGS::from_binary(binary_corrupted), std::runtime_error)
+    << "Binary data with invalid magic rejected.";
+
+  BinaryWriter writer;
+  for (unsigned x : {0u, 2u, 2u})
+    writer.write(x);
+
+  BinaryReader reader(writer.str().data(), writer.str().size());
+
+  EXPECT_THROW(reader.read_perm(3u), std::runtime_error)
+    << "Non-bijective permutation rejected.";
+}
+
 //TEST(BSGSBaseSwapTest, CanConjugateBSGS)
 //{
 //  PermGroup pg(5, {Perm(5, {{1, 2}, {3, 4}}), Perm(5, {{1, 4, 2}})});
@@ -0,0 +1,80 @@
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "csr_graph.hpp"
+
+#include "test_main.cpp"
+
+using namespace mpsym::internal;
+
+using testing::ElementsAre;
+using testing::UnorderedElementsAre;
+
+namespace
+{
+
+std::vector<int> neighbours(CSRGraph const &graph, int v)
+{ return std::vector<int>(graph.neighbours_begin(v), graph.neighbours_end(v)); }
+
+} // anonymous namespace
+
+TEST(CSRGraphTest, CanConstructEmptyGraph)
+{
+  CSRGraph graph(3);
+
+  EXPECT_EQ(3, graph.num_vertices())
+    << "Number of vertices correct.";
+
+  EXPECT_EQ(0u, graph.num_arcs())
+    << "Number of arcs correct.";
+
+  for (int v = 0; v < 3; ++v) {
+    EXPECT_EQ(0, graph.degree(v))
+      << "Vertex degrees correct.";
+  }
+}
+
+TEST(CSRGraphTest, CanConstructFromArcs)
+{
+  std::vector<std::pair<int, int>> edges {{0, 1}, {3, 0}, {1, 2}, {0, 2}, {4, 4}};
+
+  CSRGraph graph(5, [&](CSRGraph::Arcs &arc){
+    for (auto const &edge : edges) {
+      arc(edge.first, edge.second);
+
+      if (edge.first != edge.second)
+        arc(edge.second, edge.first);
+    }
+  });
+
+  EXPECT_EQ(5, graph.num_vertices())
+    << "Number of vertices correct.";
+
+  EXPECT_EQ(9u, graph.num_arcs())
+    << "Number of arcs correct.";
+
+  EXPECT_THAT(neighbours(graph, 0), UnorderedElementsAre(1, 2, 3))
+    << "Neighbours correct.";
+  EXPECT_THAT(neighbours(graph, 1), UnorderedElementsAre(0, 2))
+    << "Neighbours correct.";
+  EXPECT_THAT(neighbours(graph, 2), UnorderedElementsAre(0, 1))
+    << "Neighbours correct.";
+  EXPECT_THAT(neighbours(graph, 3), ElementsAre(0))
+    << "Neighbours correct.";
+  EXPECT_THAT(neighbours(graph, 4), ElementsAre(4))
+    << "Neighbours correct.";
+
+  for (int v = 0; v < 5; ++v) {
+    EXPECT_EQ(graph.offset(v) + graph.degree(v),
+              v < 4 ? graph.offset(v + 1) : graph.num_arcs())
+      << "Offsets consistent with degrees.";
+  }
+
+  EXPECT_THAT(graph.offsets(), ElementsAre(0u, 3u, 5u, 7u, 8u, 9u))
+    << "Offset array correct.";
+
+  EXPECT_THAT(graph.degrees(), ElementsAre(3, 2, 2, 1, 1))
+    << "Degree array correct.";
+}
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#include "gmock/gmock.h"
+
+#include "dbg.hpp"
+
+#include "test_main.cpp"
+
+using namespace mpsym::internal;
+
+class DbgTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    _loglevel = dbg::Dbg::loglevel;
+    _out = dbg::Dbg::out;
+
+    dbg::Dbg::out = &_buf;
+  }
+
+  void TearDown() override
+  {
+    DBG_SET_LOGLEVEL(_loglevel);
+    DBG_SET_TRACE_SAMPLING(1u);
+
+    dbg::Dbg::out = _out;
+  }
+
+  unsigned num_lines() const
+  {
+    auto str(_buf.str());
+    return static_cast<unsigned>(std::count(str.begin(), str.end(), '\n'));
+  }
+
+private:
+  int _loglevel;
+  std::ostream *_out;
+  std::stringstream _buf;
+};
+
+TEST_F(DbgTest, CanFilterLogLevels)
+{
+  DBG_SET_LOGLEVEL(DEBUG);
+
+  DBG(TRACE) << "trace";
+  DBG(DEBUG) << "debug";
+  DBG(WARN) << "warning";
+
+  unsigned expected = 0u;
+  if (DEBUG >= DBG_LEVEL_MIN)
+    ++expected;
+  if (WARN >= DBG_LEVEL_MIN)
+    ++expected;
+
+  EXPECT_EQ(expected, num_lines())
+    << "Only statements at or above the log level emitted.";
+}
+
+TEST_F(DbgTest, CanSampleTraces)
+{
+  if (TRACE < DBG_LEVEL_MIN)
+    GTEST_SKIP() << "Trace statements not compiled in.";
+
+  DBG_SET_LOGLEVEL(TRACE);
+  DBG_SET_TRACE_SAMPLING(10u);
+
+  for (unsigned i = 0u; i < 100u; ++i)
+    DBG(TRACE) << "trace " << i;
+
+  EXPECT_EQ(10u, num_lines())
+    << "Every n-th trace statement emitted.";
+}
@@ -0,0 +1,103 @@
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gmock/gmock.h"
+
+#include "bsgs.hpp"
+#include "instrument.hpp"
+#include "perm.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+
+#include "test_main.cpp"
+
+using namespace mpsym::internal;
+
+class InstrumentTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    instrument::reset();
+    instrument::enable();
+  }
+
+  void TearDown() override
+  {
+    instrument::enable(false);
+    instrument::reset();
+  }
+};
+
+TEST_F(InstrumentTest, CanCountProbes)
+{
+  PermGroup pg(PermGroup::symmetric(8));
+
+  instrument::reset();
+
+  auto counters(instrument::collect());
+
+  EXPECT_EQ(0u, counters.count[instrument::STRIP])
+    << "No counts after reset.";
+
+  Perm perm(8, {{0, 1, 2, 3, 4, 5, 6, 7}});
+
+  for (unsigned i = 0u; i < 10u; ++i)
+    pg.bsgs().strip(perm);
+
+  counters = instrument::collect();
+
+  EXPECT_EQ(10u, counters.count[instrument::STRIP])
+    << "Strip calls counted correctly.";
+
+  unsigned long long histogram_total = 0ULL;
+  for (unsigned b = 0u; b < instrument::NUM_BUCKETS; ++b)
+    histogram_total += counters.histogram[instrument::STRIP][b];
+
+  EXPECT_EQ(10u, histogram_total)
+    << "Strip latencies recorded in histogram.";
+
+  instrument::enable(false);
+
+  pg.bsgs().strip(perm);
+
+  EXPECT_EQ(10u, instrument::collect().count[instrument::STRIP])
+    << "Disabled instrumentation does not count.";
+}
+
+TEST_F(InstrumentTest, CanCollectFromExitedThreads)
+{
+  std::thread thread([]{
+    PermGroup pg(PermGroup::symmetric(6));
+  });
+
+  thread.join();
+
+  auto counters(instrument::collect());
+
+  EXPECT_GT(counters.count[instrument::SCHREIER_GENERATOR], 0u)
+    << "Counts of exited threads are retained.";
+
+  EXPECT_GT(counters.count[instrument::ORBIT_EXPANSION], 0u)
+    << "Counts of exited threads are retained.";
+}
+
+TEST_F(InstrumentTest, CanDumpCounters)
+{
+  PermGroup pg(PermGroup::dihedral(8));
+
+  auto json(instrument::dump_json());
+
+  EXPECT_EQ('{', json.front());
+  EXPECT_EQ('}', json.back());
+
+  EXPECT_NE(std::string::npos, json.find("\"strip\":{\"count\":"))
+    << "JSON dump contains probe counters.";
+
+  std::stringstream ss;
+  instrument::dump_text(ss);
+
+  EXPECT_NE(std::string::npos, ss.str().find("INSTRUMENT (strip)"))
+    << "Text dump contains probe counters.";
+}
@@ -0,0 +1,183 @@
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "orbit.hpp"
+#include "perm.hpp"
+#include "perm_set.hpp"
+
+#include "test_main.cpp"
+
+using namespace mpsym;
+using namespace mpsym::internal;
+
+using testing::UnorderedElementsAreArray;
+
+TEST(OrbitTest, CanGenerateOrbit)
+{
+  PermSet generators({Perm(10, {{0, 2, 4}}), Perm(10, {{4, 6}, {8, 9}})});
+
+  auto orbit(Orbit::generate(2, generators.with_inverses()));
+
+  EXPECT_THAT(std::vector<unsigned>(orbit.begin(), orbit.end()),
+              UnorderedElementsAreArray({0u, 2u, 4u, 6u}))
+    << "Orbit generated correctly.";
+
+  for (unsigned x = 0u; x < 12u; ++x) {
+    bool expected = x == 0u || x == 2u || x == 4u || x == 6u;
+
+    EXPECT_EQ(expected, orbit.contains(x))
+      << "Orbit membership determined correctly.";
+  }
+
+  EXPECT_TRUE(orbit.generated_by(6, generators))
+    << "Orbit generator determined correctly.";
+
+  EXPECT_FALSE(orbit.generated_by(8, generators))
+    << "Orbit generator determined correctly.";
+}
+
+TEST(OrbitTest, CanUpdateOrbit)
+{
+  PermSet generators_old({Perm(10, {{0, 2, 4}})});
+  PermSet generators_new({Perm(10, {{4, 6}, {8, 9}})});
+
+  auto orbit(Orbit::generate(0, generators_old.with_inverses()));
+
+  orbit.update(generators_old.with_inverses(), generators_new.with_inverses());
+
+  EXPECT_THAT(std::vector<unsigned>(orbit.begin(), orbit.end()),
+              UnorderedElementsAreArray({0u, 2u, 4u, 6u}))
+    << "Orbit updated correctly.";
+
+  EXPECT_TRUE(orbit.contains(6))
+    << "Orbit membership determined correctly after update.";
+}
+
+TEST(OrbitTest, CanCompareOrbits)
+{
+  EXPECT_EQ(Orbit({3, 1, 2}), Orbit({1, 2, 3}))
+    << "Orbit comparison independent of element order.";
+
+  EXPECT_NE(Orbit({1, 2, 3}), Orbit({1, 2, 4}))
+    << "Orbits of same size with different elements distinguished.";
+
+  EXPECT_NE(Orbit({1, 2, 3}), Orbit({1, 2, 100}))
+    << "Orbits with differently sized member sets distinguished.";
+
+  Orbit orbit({1, 2, 100});
+  orbit.erase(orbit.begin() + 2);
+  orbit.insert(3);
+
+  EXPECT_EQ(Orbit({1, 2, 3}), orbit)
+    << "Orbit comparison correct after modification.";
+}
+
+TEST(OrbitPartitionTest, CanConstructOrbitPartition)
+{
+  PermSet generators({Perm(10, {{0, 2, 4}}), Perm(10, {{4, 6}, {8, 9}})});
+
+  OrbitPartition orbits(10, generators);
+
+  std::vector<std::vector<unsigned>> expected_orbits {
+    {0, 2, 4, 6}, {1}, {3}, {5}, {7}, {8, 9}
+  };
+
+  ASSERT_EQ(expected_orbits.size(), orbits.num_partitions())
+    << "Correct number of orbits.";
+
+  for (unsigned i = 0u; i < orbits.num_partitions(); ++i) {
+    EXPECT_THAT(std::vector<unsigned>(orbits[i].begin(), orbits[i].end()),
+                UnorderedElementsAreArray(expected_orbits[i]))
+      << "Orbit partition constructed correctly.";
+
+    for (unsigned x : expected_orbits[i]) {
+      EXPECT_EQ(static_cast<int>(i), orbits.partition_index(x))
+        << "Orbit partition indices correct.";
+    }
+  }
+}
+
+TEST(OrbitPartitionTest, CanConstructLargeOrbitPartition)
+{
+  unsigned degree = 4096u;
+
+  PermSet generators;
+  for (unsigned i = 0u; i < 256u; ++i)
+    generators.insert(Perm(degree, {{2u * i, 2u * i + 1u}}));
+
+  OrbitPartition orbits(degree, generators);
+
+  EXPECT_EQ(degree - 256u, orbits.num_partitions())
+    << "Correct number of orbits.";
+
+  for (unsigned i = 0u; i < 256u; ++i) {
+    EXPECT_EQ(orbits.partition_index(2u * i), orbits.partition_index(2u * i + 1u))
+      << "Orbit partition constructed correctly.";
+  }
+
+  std::size_t memory = 0u;
+  for (auto const &orbit : orbits)
+    memory += orbit.memory_usage();
+
+  EXPECT_LT(memory, 16u * degree)
+    << "Orbit partition memory usage linear in degree.";
+
+  EXPECT_TRUE(orbits[orbits.partition_index(4094u)].contains(4094u))
+    << "Orbit partition membership determined correctly.";
+
+  EXPECT_FALSE(orbits[orbits.partition_index(4094u)].contains(4095u))
+    << "Orbit partition membership determined correctly.";
+
+  EXPECT_EQ(Orbit({0u, 1u}), orbits[0])
+    << "Orbit partition orbits comparable to other orbits.";
+}
+
+TEST(OrbitPartitionTest, CanAddGenerators)
+{
+  PermSet generators({Perm(10, {{0, 2, 4}})});
+
+  OrbitPartition orbits(10, generators);
+
+  orbits.add_generator(Perm(10, {{4, 6}, {8, 9}}));
+
+  EXPECT_EQ(OrbitPartition(10, {Perm(10, {{0, 2, 4}}),
+                                Perm(10, {{4, 6}, {8, 9}})}), orbits)
+    << "Orbit partition refined correctly.";
+
+  orbits.add_generator(Perm(10, {{1, 8}}));
+  orbits.add_generator(Perm(10, {{3, 5, 7}}));
+
+  EXPECT_EQ(3u, orbits.num_partitions())
+    << "Orbit partition refined correctly.";
+
+  orbits.add_generator(Perm(10, {{0, 1}, {3, 9}}));
+
+  EXPECT_EQ(1u, orbits.num_partitions())
+    << "Orbit partition refined correctly.";
+}
+
+TEST(OrbitPartitionTest, CanAddGeneratorsAfterModification)
+{
+  OrbitPartition orbits(10, {Perm(10, {{0, 2, 4}, {5, 7}})});
+
+  orbits.change_partition(4, orbits.partition_index(5));
+
+  orbits.add_generator(Perm(10, {{2, 8}}));
+
+  EXPECT_EQ(OrbitPartition(10, {Perm(10, {{0, 2, 8}}),
+                                Perm(10, {{4, 5, 7}})}), orbits)
+    << "Orbit partition refined correctly after modification.";
+}
+
+TEST(OrbitPartitionTest, CanMergePartitions)
+{
+  OrbitPartition orbits(10, {Perm(10, {{0, 2, 4}}), Perm(10, {{8, 9}})});
+
+  orbits.merge_partitions({{1u, 6u}, {2u, 3u}});
+
+  EXPECT_EQ(OrbitPartition(10, {Perm(10, {{0, 2, 4}}),
+                                Perm(10, {{1, 8, 9}}),
+                                Perm(10, {{3, 5}})}), orbits)
+    << "Orbit partitions merged correctly.";
+}
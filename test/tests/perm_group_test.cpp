@@ -1,14 +1,21 @@
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include <dirent.h>
+#include <unistd.h>
+
 #include "gmock/gmock.h"
 
 #include "bsgs.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
+#include "perm_group_cache.hpp"
 #include "perm_set.hpp"
 #include "test_utility.hpp"
 #include "util.hpp"
@@ -165,6 +172,34 @@ TEST(PermGroupTest, CanTestMembership)
   }
 }
 
+TEST(PermGroupTest, CanTestMembershipBatched)
+{
+  PermGroup a4(verified_perm_group(A4));
+  PermGroup s4(PermGroup::symmetric(4));
+
+  PermSet perms;
+  std::vector<bool> expected;
+
+  for (unsigned i = 0u; i < 50u; ++i) {
+    for (Perm const &perm : s4) {
+      perms.insert(perm);
+      expected.push_back(perm.even());
+    }
+  }
+
+  for (unsigned num_threads : {1u, 4u}) {
+    EXPECT_EQ(expected, a4.contains_elements(perms, num_threads))
+      << "Batched membership test correct (" << num_threads << " threads).";
+  }
+
+  EXPECT_EQ(std::vector<bool>(perms.size(), true), s4.contains_elements(perms))
+    << "Batched membership test correct for symmetric group.";
+
+  EXPECT_EQ(std::vector<bool>({true, false}),
+            PermGroup(4).contains_elements({Perm(4), Perm(4, {{0, 1}})}))
+    << "Batched membership test correct for trivial group.";
+}
+
 TEST(PermGroupTest, CanGenerateRandomElement)
 {
   PermGroup a4(verified_perm_group(A4));
@@ -175,6 +210,126 @@ TEST(PermGroupTest, CanGenerateRandomElement)
   }
 }
 
+TEST(PermGroupTest, CanComputeFingerprint)
+{
+  PermGroup pg1(6, {Perm(6, {{0, 1, 2}}), Perm(6, {{0, 1}})});
+  PermGroup pg2(6, {Perm(6, {{1, 2}}), Perm(6, {{0, 2}})});
+  PermGroup pg3(6, {Perm(6, {{3, 4, 5}}), Perm(6, {{3, 4}})});
+  PermGroup pg4(6, {Perm(6, {{0, 1, 2}})});
+
+  EXPECT_EQ(pg1.fingerprint(), pg2.fingerprint())
+    << "Fingerprint independent of generators.";
+
+  EXPECT_NE(pg1.fingerprint(), pg3.fingerprint())
+    << "Fingerprint distinguishes groups acting on different orbits.";
+
+  EXPECT_NE(pg1.fingerprint(), pg4.fingerprint())
+    << "Fingerprint distinguishes groups of different order.";
+
+  EXPECT_EQ(PermGroup(6).fingerprint(), PermGroup(6).fingerprint())
+    << "Fingerprint of trivial group well defined.";
+}
+
+TEST(PermGroupTest, CanCacheGroups)
+{
+  PermGroupCache cache;
+
+  PermGroup pg1(6, {Perm(6, {{0, 1, 2}}), Perm(6, {{0, 1}})});
+  PermGroup pg2(6, {Perm(6, {{1, 2}}), Perm(6, {{0, 2}})});
+  PermGroup pg3(6, {Perm(6, {{3, 4, 5}}), Perm(6, {{3, 4}})});
+
+  EXPECT_FALSE(cache.find("pg1"))
+    << "Cache initially empty.";
+
+  cache.insert("pg1", pg1);
+  cache.insert("pg2", pg2);
+  cache.insert("pg3", pg3);
+
+  EXPECT_EQ(3u, cache.num_keys())
+    << "All keys cached.";
+
+  EXPECT_EQ(2u, cache.num_groups())
+    << "Equal groups shared.";
+
+  auto cached(cache.find("pg2"));
+
+  ASSERT_TRUE(cached)
+    << "Cached group found.";
+
+  EXPECT_TRUE(perm_group_equal(pg2, *cached))
+    << "Cached group correct.";
+
+  cache.clear();
+
+  EXPECT_FALSE(cache.find("pg1"))
+    << "Cache can be cleared.";
+}
+
+TEST(PermGroupTest, CanCacheGroupsOnDisk)
+{
+  char tmpdir[] = "perm_group_cache_XXXXXX";
+  ASSERT_NE(nullptr, mkdtemp(tmpdir))
+    << "Created temporary directory.";
+
+  PermGroupDiskCache cache(tmpdir);
+
+  PermGroup pg(6, {Perm(6, {{0, 1, 2}}), Perm(6, {{0, 1}, {3, 4}})});
+
+  EXPECT_FALSE(cache.load("pg"))
+    << "Cache initially empty.";
+
+  EXPECT_TRUE(cache.store("pg", pg.bsgs()))
+    << "Cache entry stored.";
+
+  auto cached(cache.load("pg"));
+
+  ASSERT_TRUE(cached)
+    << "Cached group found.";
+
+  EXPECT_TRUE(perm_group_equal(pg, PermGroup(*cached)))
+    << "Cached group correct.";
+
+  EXPECT_FALSE(cache.load("other"))
+    << "Other keys not found.";
+
+  EXPECT_TRUE(cache.store("pg", PermGroup(6).bsgs()))
+    << "Cache entry overwritten.";
+
+  cached = cache.load("pg");
+
+  ASSERT_TRUE(cached)
+    << "Cached group found after overwrite.";
+
+  EXPECT_TRUE(PermGroup(*cached).is_trivial())
+    << "Cached group correctly overwritten.";
+
+  DIR *dir = opendir(tmpdir);
+  while (struct dirent *entry = readdir(dir)) {
+    std::string name(entry->d_name);
+    if (name != "." && name != "..")
+      std::remove((std::string(tmpdir) + "/" + name).c_str());
+  }
+  closedir(dir);
+
+  rmdir(tmpdir);
+
+  PermGroupDiskCache cache_unwritable(std::string(tmpdir) + "/missing");
+
+  bool stored = true;
+  std::string error;
+  EXPECT_NO_THROW(stored = cache_unwritable.store("pg", pg.bsgs(), &error))
+    << "Failing to write cache entries is not an error.";
+
+  EXPECT_FALSE(stored)
+    << "Failing to write cache entries is reported.";
+
+  EXPECT_FALSE(error.empty())
+    << "Failing to write cache entries is described.";
+
+  EXPECT_FALSE(cache_unwritable.load("pg"))
+    << "Unwritable cache stays empty.";
+}
+
 TEST(PermGroupTest, CanIterateTrivialGroup)
 {
   PermGroup id = PermGroup(4, {});
@@ -644,6 +799,42 @@ INSTANTIATE_TEST_SUITE_P(DisjointSubgroupProductVariants,
                                                std::make_pair(true, false),
                                                std::make_pair(true, true)));
 
+TEST(DisjointSubgroupProductOptionsTest, DisjointSubgroupsRespectOptions)
+{
+  std::vector<unsigned> cycle1(32u), cycle2(32u);
+  for (unsigned i = 0u; i < 32u; ++i) {
+    cycle1[i] = i;
+    cycle2[i] = i + 32u;
+  }
+
+  PermGroup pg(64, {Perm(64, {cycle1}), Perm(64, {cycle2})});
+
+  BSGSOptions options;
+  options.transversals = BSGSOptions::Transversals::SCHREIER_TREES;
+
+  for (bool complete : {true, false}) {
+    auto disjoint_subgroups_explicit(
+      pg.disjoint_decomposition(complete));
+
+    auto disjoint_subgroups_schreier_trees(
+      pg.disjoint_decomposition(complete, false, &options));
+
+    ASSERT_EQ(disjoint_subgroups_explicit, disjoint_subgroups_schreier_trees)
+      << "Disjoint subgroups independent of transversal storage.";
+
+    std::size_t memory_usage_explicit = 0u;
+    for (PermGroup const &pg_explicit : disjoint_subgroups_explicit)
+      memory_usage_explicit += pg_explicit.bsgs().memory_usage();
+
+    std::size_t memory_usage_schreier_trees = 0u;
+    for (PermGroup const &pg_schreier_trees : disjoint_subgroups_schreier_trees)
+      memory_usage_schreier_trees += pg_schreier_trees.bsgs().memory_usage();
+
+    EXPECT_LT(memory_usage_schreier_trees, memory_usage_explicit)
+      << "Transversal storage option applied to disjoint subgroups.";
+  }
+}
+
 //TEST(DISABLED_WreathProductTest, CanFindWreathProduct)
 //{
 //  PermGroup pg(12,
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <sstream>
 #include <unordered_set>
 #include <vector>
@@ -194,5 +195,11 @@ TEST(PermTest, CanRestrictPerm)
   for (auto const &pr : perm_restrictions) {
     EXPECT_EQ(pr.expected, pr.perm.restricted(pr.domain.begin(), pr.domain.end()))
       << "Restricting permutation yields correct result.";
+
+    auto in_domain = [&](unsigned x)
+    { return std::find(pr.domain.begin(), pr.domain.end(), x) != pr.domain.end(); };
+
+    EXPECT_EQ(pr.expected, pr.perm.restricted_if(in_domain))
+      << "Restricting permutation by predicate yields correct result.";
   }
 }
@@ -114,3 +114,25 @@ TEST_F(PRRandomizerTest, CanTestForAltSym)
       << "Can identify non-symmetric generating sets.";
   }
 }
+
+TEST_F(PRRandomizerTest, CanRuleOutAltSymWithoutSampling)
+{
+  PermSet gens_intransitive {
+    Perm(10, {{0, 1}}), Perm(10, {{0, 1, 2, 3, 4, 5, 6, 7, 8}})};
+
+  PermSet gens_imprimitive {
+    Perm(10, {{0, 1}}), Perm(10, {{0, 2, 4, 6, 8}, {1, 3, 5, 7, 9}}),
+    Perm(10, {{0, 2}, {1, 3}})};
+
+  PermSet gens_jordan {
+    Perm(10, {{0, 1, 2, 3, 4, 5, 6}}), Perm(10, {{6, 7, 8, 9}})};
+
+  EXPECT_FALSE(PrRandomizer(gens_intransitive, 10, 0).test_symmetric())
+    << "Can identify intransitive generating sets.";
+
+  EXPECT_FALSE(PrRandomizer(gens_imprimitive, 10, 0).test_symmetric())
+    << "Can identify imprimitive generating sets.";
+
+  EXPECT_TRUE(PrRandomizer(gens_jordan, 10, 0).test_symmetric())
+    << "Can identify symmetric generating sets containing a p-cycle.";
+}
@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <functional>
 #include <memory>
+#include <set>
 #include <thread>
 
 #include "gmock/gmock.h"
@@ -97,4 +98,99 @@ TEST(TimeoutTest, CanTimeoutFunction)
   wait_for_timed_out_threads();
 }
 
+TEST(TimeoutTest, CanReuseWorkerThreads)
+{
+  enum : unsigned { CALLS = 20u };
+
+  std::set<std::thread::id> ids;
+
+  for (unsigned i = 0u; i < CALLS; ++i) {
+    ids.insert(run_with_timeout("thread_id",
+                                ms(1000),
+                                []{ return std::this_thread::get_id(); }));
+  }
+
+  EXPECT_LT(ids.size(), CALLS)
+    << "Consecutive calls reuse worker threads.";
+
+  auto endless_loop = [](flag aborted)
+  {
+    while (!is_set(aborted))
+      sleep(ms(1));
+
+    throw AbortedError("endless_loop_abort");
+  };
+
+  for (unsigned i = 0u; i < CALLS; ++i) {
+    EXPECT_THROW(run_abortable_with_timeout("endless_loop", ms(10), endless_loop),
+                 TimeoutError);
+  }
+
+  wait_for_timed_out_threads();
+
+  EXPECT_LT(WorkerPool::instance().num_workers(), CALLS)
+    << "Timed out calls return their worker thread to the pool.";
+}
+
+TEST(TimeoutTest, CanTimeoutBeforeWorkerStarts)
+{
+  enum : unsigned { CALLS = 100u };
+
+  auto busy_loop = [](flag aborted)
+  {
+    while (!is_set(aborted))
+      ;
+
+    throw AbortedError("busy_loop");
+  };
+
+  for (unsigned i = 0u; i < CALLS; ++i) {
+    EXPECT_THROW((run_abortable_with_timeout(
+                   "busy_loop",
+                   std::chrono::microseconds(1),
+                   [&](flag aborted)
+                   { busy_loop(aborted); return 42; })),
+                 TimeoutError)
+      << "Deadline expiring inside worker yields timeout (non-void).";
+
+    EXPECT_THROW(run_abortable_with_timeout(
+                   "busy_loop",
+                   std::chrono::microseconds(1),
+                   [&](flag aborted)
+                   { busy_loop(aborted); }),
+                 TimeoutError)
+      << "Deadline expiring inside worker yields timeout (void).";
+  }
+
+  wait_for_timed_out_threads();
+}
+
+TEST(TimeoutTest, CanExpireFlagAtDeadline)
+{
+  flag f(unset(ms(50)));
+
+  EXPECT_FALSE(is_set(f))
+    << "Flag is not set before deadline.";
+
+  sleep(ms(100));
+
+  EXPECT_TRUE(is_set(f))
+    << "Flag is set after deadline.";
+}
+
+TEST(TimeoutTest, CanPollFlagPeriodically)
+{
+  flag f(unset());
+
+  Poll poll(f, 4u);
+
+  set(f);
+
+  for (unsigned i = 0u; i < 3u; ++i)
+    EXPECT_NO_THROW(poll("poll")) << "Flag is not consulted on every poll.";
+
+  EXPECT_THROW_WITH_MESSAGE(poll("poll"), AbortedError, "poll aborted")
+    << "Flag is consulted on every n-th poll.";
+}
+
 } // anonymous namespace